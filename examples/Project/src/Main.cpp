@@ -1,7 +1,6 @@
 #include <Velkro/Velkro.h>
 
 #include <iostream>
-#include <chrono>
 
 namespace Project
 {
@@ -29,6 +28,8 @@ namespace Project
 
 		Engine->AddEntity(entity);
 
+		Engine->SetFixedTimestep(60.0);
+
 		return ExitCode::Success;
 	}
 
@@ -83,15 +84,7 @@ namespace Project
 
 	ExitCode Loop()
 	{
-		static std::chrono::steady_clock::time_point lastFrameTime = std::chrono::steady_clock::now();
-
-		auto currentFrameTime = std::chrono::steady_clock::now();
-
-		std::chrono::duration<float> deltaTime = currentFrameTime - lastFrameTime;
-
-		lastFrameTime = currentFrameTime;
-
-		float deltaTimeInSeconds = deltaTime.count();
+		float deltaTimeInSeconds = static_cast<float>(Velkro::Engine::GetDeltaTime());
 
 		if (Window->GetWindowClosed())
 		{
@@ -3,6 +3,10 @@
 #include "../../src/Entity.h" // TODO: Fix up the include system a bit and change this
 #include "../../src/Component.h"
 #include "../../src/Event.h"
+#include "../../src/Task.h"
+#include "../../src/Timer.h"
+#include "../../src/AtlasBuilder.h"
+#include "../../src/Font.h"
 
 // TODO: Move this somewhere better (GLFW Keycodes)
 #define KEY_RELEASE                0
@@ -156,10 +160,36 @@ namespace Velkro
 
 		static void AddEntity(Entity* entity);
 
+		static void SetFixedTimestep(double updateRate, int maxUpdatesPerFrame = 5); // Runs updates at a fixed rate, rendering interpolates between the last two updates.
+		static void SetVariableTimestep();
+		static void SetRenderRate(double renderRate); // 0 renders as fast as possible.
+		static void SetPipelined(bool pipelined); // Renders on a separate thread one frame behind the simulation, set before Run.
+		static void SetHotReload(bool hotReload); // Reloads shaders and textures when their files change, meant for development.
+
+		static bool IsFixedTimestep();
+
+		static double GetTime();
+		static double GetDeltaTime(); // Step of the current update, fixed when using a fixed timestep.
+		static double GetFrameTime(); // Real time taken by the last frame.
+		static float GetInterpolationAlpha();
+
 	private:
 		static void OnEvent(Event* event, const char* windowComponentUUID, const char* entityUUID);
 
 		bool m_Running = true;
+
+		static inline bool m_FixedTimestep = false;
+		static inline bool m_Pipelined = false;
+
+		static inline double m_UpdateRate = 60.0;
+		static inline double m_RenderRate = 0.0;
+
+		static inline int m_MaxUpdatesPerFrame = 5;
+
+		static inline double m_Time = 0.0;
+		static inline double m_DeltaTime = 0.0;
+		static inline double m_FrameTime = 0.0;
+		static inline float m_InterpolationAlpha = 1.0f;
 		
 		static inline OnEventFunctionEngine m_OnEventFunction;
 
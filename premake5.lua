@@ -26,5 +26,32 @@ project "LibVelkro"
 		defines { "VLK_CONFIG_DEBUG" }
 		symbols "On"
 
+	filter "configurations:Release"
+		optimize "On"
+
+project "VelkroCook"
+	kind "ConsoleApp"
+
+	language "C++"
+	cppdialect "C++latest"
+
+	architecture "x64"
+
+	targetdir "bin/%{prj.name}/%{cfg.architecture}-%{cfg.buildcfg}"
+	objdir "bin-int/%{prj.name}/%{cfg.architecture}-%{cfg.buildcfg}"
+
+	files { "tools/VelkroCook/src/**.h", "tools/VelkroCook/src/**.cpp", "src/Cooked.h", "src/Image.h", "src/Image.cpp", "src/IO.h", "src/IO.cpp", "src/VFS.cpp", "src/Archive.h", "src/LZ4.h", "src/LZ4.cpp", "src/MeshOptimizer.h", "src/MeshOptimizer.cpp", "src/VertexLayout.h", "src/stb.cpp" }
+
+	includedirs { "src", "vendor/glad/include", "vendor/stb" }
+
+	configurations { "Debug", "Release" }
+
+	filter "toolset:gcc or toolset:clang"
+		defines { "_GLIBCXX_PRINT" }
+
+	filter "configurations:Debug"
+		defines { "VLK_CONFIG_DEBUG" }
+		symbols "On"
+
 	filter "configurations:Release"
 		optimize "On"
\ No newline at end of file
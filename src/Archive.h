@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+// Layout of .vpak archives written by VelkroCook pack. The table of contents is sorted by path hash for binary search,
+// each entry is stored raw or LZ4 compressed, whichever is smaller.
+namespace Velkro::Archive
+{
+	static constexpr uint32_t Magic = 0x4B415056; // "VPAK"
+	static constexpr uint32_t Version = 1;
+
+	static constexpr uint32_t EntryCompressed = 1 << 0;
+
+	struct Header
+	{
+		uint32_t magic = Magic;
+		uint32_t version = Version;
+
+		uint32_t entryCount = 0;
+		uint32_t reserved = 0;
+
+		uint64_t entriesOffset = 0;
+		uint64_t namesOffset = 0;
+	};
+
+	struct Entry
+	{
+		uint64_t hash;
+
+		uint64_t offset;
+		uint64_t storedSize; // Size in the archive.
+		uint64_t size; // Size once decompressed.
+
+		uint32_t nameOffset, nameLength; // Into the name table, to tell hash collisions apart.
+		uint32_t flags;
+		uint32_t reserved;
+	};
+
+	// Relative, forward slashes and no "." or ".." parts, so "./assets\\a.png" and "assets/a.png" find the same entry.
+	inline std::string NormalizePath(std::string_view path)
+	{
+		std::string normalized = std::filesystem::path(path).lexically_normal().generic_string();
+
+		while (normalized.starts_with("./"))
+		{
+			normalized.erase(0, 2);
+		}
+
+		return normalized;
+	}
+
+	inline uint64_t HashPath(std::string_view normalizedPath)
+	{
+		uint64_t hash = 0xCBF29CE484222325ull;
+
+		for (char character : normalizedPath)
+		{
+			hash ^= static_cast<uint8_t>(character);
+			hash *= 0x100000001B3ull;
+		}
+
+		return hash;
+	}
+}
\ No newline at end of file
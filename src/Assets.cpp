@@ -0,0 +1,501 @@
+#include "Assets.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <unordered_map>
+
+#include "Renderer.h"
+#include "FramePipeline.h"
+#include "CommandBuffer.h"
+#include "FileWatcher.h"
+#include "Font.h"
+#include "Log.h"
+
+namespace Velkro::Assets
+{
+	static std::unordered_map<std::string, Texture2DAsset*> Textures;
+	static std::unordered_map<std::string, ShaderAsset*> Shaders;
+	static std::unordered_map<std::string, FontAsset*> Fonts;
+
+	static std::vector<ShaderAsset*> PreloadedShaders;
+
+	static bool HotReload = false;
+
+	static std::string GetSamplerKey(const Sampler& sampler)
+	{
+		return std::format("{}{}{}{}{}{}{}", static_cast<int>(sampler.minFilter), static_cast<int>(sampler.magFilter), static_cast<int>(sampler.mipFilter),
+			static_cast<int>(sampler.wrapS), static_cast<int>(sampler.wrapT), sampler.mipmaps ? 1 : 0, sampler.anisotropy);
+	}
+
+	static void DeleteTexture(void* userData)
+	{
+		uint32_t textureID = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(userData));
+
+		glDeleteTextures(1, &textureID);
+	}
+
+	static void DeleteProgram(void* userData)
+	{
+		Renderer::DeleteShader(static_cast<uint32_t>(reinterpret_cast<uintptr_t>(userData)));
+	}
+
+	// Always recorded, so the delete runs on the thread owning the context and after the frame's draws already recorded
+	// with the object, even when the frame pipeline replays them inline.
+	static void DeleteOnContextThread(void (*function)(void*), uint32_t ID)
+	{
+		CommandBuffer::Get().Call(function, reinterpret_cast<void*>(static_cast<uintptr_t>(ID)));
+	}
+
+	static void OnTextureStreamed(void* userData, uint32_t textureID, int width, int height, int channels)
+	{
+		Texture2DAsset* asset = static_cast<Texture2DAsset*>(userData);
+
+		// A failed load keeps the placeholder, and is retried by hot reload once the file changes.
+		asset->streamRequest = 0;
+
+		if (!textureID)
+		{
+			return;
+		}
+
+		asset->ID = textureID;
+
+		asset->width = width;
+		asset->height = height;
+		asset->channels = channels;
+	}
+
+	static void OnTextureReloaded(void* userData, uint32_t textureID, int width, int height, int channels)
+	{
+		Texture2DAsset* asset = static_cast<Texture2DAsset*>(userData);
+
+		asset->reloadRequest = 0;
+
+		// The old texture stays until the file loads again.
+		if (!textureID)
+		{
+			return;
+		}
+
+		if (asset->ID && asset->ID != Renderer::GetPlaceholderTexture2D())
+		{
+			DeleteOnContextThread(DeleteTexture, asset->ID);
+		}
+
+		asset->ID = textureID;
+
+		asset->width = width;
+		asset->height = height;
+		asset->channels = channels;
+
+		VLK_CORE_INFO("Reloaded texture \"{}\".", asset->path);
+	}
+
+	static void WatchShader(ShaderAsset* asset, bool watch)
+	{
+		for (const std::string* path : { &asset->vertexPath, &asset->fragmentPath })
+		{
+			if (!path->empty())
+			{
+				watch ? FileWatcher::Watch(*path) : FileWatcher::Unwatch(*path);
+			}
+		}
+	}
+
+	static void ReloadTexture(Texture2DAsset* asset)
+	{
+		// Still streaming in the first time, that load will already see the new file.
+		if (asset->streamRequest)
+		{
+			return;
+		}
+
+		if (asset->reloadRequest)
+		{
+			Renderer::CancelTexture2DAsync(asset->reloadRequest);
+		}
+
+		asset->reloadRequest = Renderer::LoadTexture2DAsync(asset->path.c_str(), asset->sampler, OnTextureReloaded, asset);
+	}
+
+	static void ReloadShader(ShaderAsset* asset)
+	{
+		if (FramePipeline::IsRunning())
+		{
+			VLK_CORE_WARN("Shader \"{}\" changed but can't be reloaded while the frame pipeline owns the GL context.", asset->vertexPath);
+
+			return;
+		}
+
+		if (asset->pendingID)
+		{
+			Renderer::DeleteShader(asset->pendingID);
+		}
+
+		asset->pendingID = asset->fragmentPath.empty() ? Renderer::LoadCookedShader(asset->vertexPath.c_str(), asset->defines) : Renderer::LoadShaderFromFile(asset->vertexPath.c_str(), asset->fragmentPath.c_str(), asset->defines);
+	}
+
+	void SetHotReload(bool enabled)
+	{
+		if (enabled == HotReload)
+		{
+			return;
+		}
+
+		HotReload = enabled;
+
+		for (auto& [key, asset] : Textures)
+		{
+			if (!asset->generated)
+			{
+				enabled ? FileWatcher::Watch(asset->path) : FileWatcher::Unwatch(asset->path);
+			}
+		}
+
+		for (auto& [key, asset] : Shaders)
+		{
+			WatchShader(asset, enabled);
+		}
+
+		if (enabled)
+		{
+			FileWatcher::Start();
+		}
+		else
+		{
+			FileWatcher::Stop();
+		}
+	}
+
+	bool IsHotReloadEnabled()
+	{
+		return HotReload;
+	}
+
+	void UpdateHotReload()
+	{
+		if (!HotReload)
+		{
+			return;
+		}
+
+		std::vector<std::string> changes = FileWatcher::PollChanges();
+
+		for (const std::string& change : changes)
+		{
+			std::string path = NormalizePath(change.c_str());
+
+			for (auto& [key, asset] : Textures)
+			{
+				if (!asset->generated && NormalizePath(asset->path.c_str()) == path)
+				{
+					ReloadTexture(asset);
+				}
+			}
+
+			for (auto& [key, asset] : Shaders)
+			{
+				if (NormalizePath(asset->vertexPath.c_str()) == path || (!asset->fragmentPath.empty() && NormalizePath(asset->fragmentPath.c_str()) == path))
+				{
+					ReloadShader(asset);
+				}
+			}
+		}
+
+		for (auto& [key, asset] : Shaders)
+		{
+			if (!asset->pendingID)
+			{
+				continue;
+			}
+
+			Renderer::ShaderStatus status = Renderer::GetShaderStatus(asset->pendingID);
+
+			if (status == Renderer::ShaderLinked)
+			{
+				if (asset->ID)
+				{
+					DeleteOnContextThread(DeleteProgram, asset->ID);
+				}
+
+				asset->ID = asset->pendingID;
+				asset->pendingID = 0;
+
+				VLK_CORE_INFO("Reloaded shader \"{}\".", asset->vertexPath);
+			}
+			else if (status == Renderer::ShaderFailed)
+			{
+				VLK_CORE_ERROR("Reloading shader \"{}\" failed, keeping the previous version.", asset->vertexPath);
+
+				DeleteOnContextThread(DeleteProgram, asset->pendingID);
+
+				asset->pendingID = 0;
+			}
+		}
+	}
+
+	std::string NormalizePath(const char* path)
+	{
+		std::error_code error;
+
+		std::filesystem::path normalized = std::filesystem::weakly_canonical(path, error);
+
+		if (error)
+		{
+			normalized = std::filesystem::path(path).lexically_normal();
+		}
+
+		return normalized.generic_string();
+	}
+
+	Texture2DAsset* AcquireTexture2D(const char* path, const Sampler& sampler, bool async)
+	{
+		std::string key = NormalizePath(path) + '|' + GetSamplerKey(sampler);
+
+		auto iterator = Textures.find(key);
+
+		if (iterator != Textures.end())
+		{
+			iterator->second->references++;
+
+			return iterator->second;
+		}
+
+		Texture2DAsset* asset = new Texture2DAsset();
+		asset->key = key;
+		asset->path = path;
+		asset->sampler = sampler;
+		asset->references = 1;
+
+		if (async)
+		{
+			asset->ID = Renderer::GetPlaceholderTexture2D();
+
+			asset->width = 1;
+			asset->height = 1;
+			asset->channels = 4;
+
+			asset->streamRequest = Renderer::LoadTexture2DAsync(path, sampler, OnTextureStreamed, asset);
+		}
+		else
+		{
+			asset->ID = Renderer::LoadTexture2D(path, asset->width, asset->height, asset->channels, sampler);
+		}
+
+		if (HotReload)
+		{
+			FileWatcher::Watch(asset->path);
+		}
+
+		Textures[key] = asset;
+
+		return asset;
+	}
+
+	Texture2DAsset* AddTexture2D(const std::string& name, uint32_t textureID, int width, int height, int channels)
+	{
+		std::string key = "generated|" + name;
+
+		if (Textures.contains(key))
+		{
+			VLK_CORE_ERROR("Texture \"{}\" was already added.", name);
+
+			return nullptr;
+		}
+
+		Texture2DAsset* asset = new Texture2DAsset();
+		asset->key = key;
+		asset->path = name;
+		asset->ID = textureID;
+		asset->width = width;
+		asset->height = height;
+		asset->channels = channels;
+		asset->references = 1;
+		asset->generated = true;
+
+		Textures[key] = asset;
+
+		return asset;
+	}
+
+	void Release(Texture2DAsset* asset)
+	{
+		if (!asset || --asset->references > 0)
+		{
+			return;
+		}
+
+		if (asset->streamRequest)
+		{
+			// The streaming code deletes the texture if it was already created.
+			Renderer::CancelTexture2DAsync(asset->streamRequest);
+		}
+		else if (asset->ID)
+		{
+			DeleteOnContextThread(DeleteTexture, asset->ID);
+		}
+
+		if (asset->reloadRequest)
+		{
+			Renderer::CancelTexture2DAsync(asset->reloadRequest);
+		}
+
+		if (HotReload && !asset->generated)
+		{
+			FileWatcher::Unwatch(asset->path);
+		}
+
+		Textures.erase(asset->key);
+
+		delete asset;
+	}
+
+	bool ShaderAsset::IsLoaded() const
+	{
+		return Renderer::GetShaderStatus(ID) == Renderer::ShaderLinked;
+	}
+
+	ShaderAsset* AcquireShader(const char* vertexShaderPath, const char* fragmentShaderPath, const std::vector<std::string>& defines)
+	{
+		std::string key = NormalizePath(vertexShaderPath) + '|' + (fragmentShaderPath ? NormalizePath(fragmentShaderPath) : std::string());
+
+		// The same feature set in any order is the same permutation.
+		std::vector<std::string> sortedDefines = defines;
+		std::sort(sortedDefines.begin(), sortedDefines.end());
+
+		for (const std::string& define : sortedDefines)
+		{
+			key += '|' + define;
+		}
+
+		auto iterator = Shaders.find(key);
+
+		if (iterator != Shaders.end())
+		{
+			iterator->second->references++;
+
+			return iterator->second;
+		}
+
+		ShaderAsset* asset = new ShaderAsset();
+		asset->key = key;
+		asset->vertexPath = vertexShaderPath;
+		asset->fragmentPath = fragmentShaderPath ? fragmentShaderPath : "";
+		asset->defines = sortedDefines;
+		asset->references = 1;
+
+		asset->ID = fragmentShaderPath ? Renderer::LoadShaderFromFile(vertexShaderPath, fragmentShaderPath, sortedDefines) : Renderer::LoadCookedShader(vertexShaderPath, sortedDefines);
+
+		if (HotReload)
+		{
+			WatchShader(asset, true);
+		}
+
+		Shaders[key] = asset;
+
+		return asset;
+	}
+
+	void Release(ShaderAsset* asset)
+	{
+		if (!asset || --asset->references > 0)
+		{
+			return;
+		}
+
+		if (asset->ID)
+		{
+			DeleteOnContextThread(DeleteProgram, asset->ID);
+		}
+
+		if (asset->pendingID)
+		{
+			DeleteOnContextThread(DeleteProgram, asset->pendingID);
+		}
+
+		if (HotReload)
+		{
+			WatchShader(asset, false);
+		}
+
+		Shaders.erase(asset->key);
+
+		delete asset;
+	}
+
+	FontAsset* AcquireFont(const char* path, float rasterSize)
+	{
+		std::string key = NormalizePath(path) + std::format("|{}", rasterSize);
+
+		auto iterator = Fonts.find(key);
+
+		if (iterator != Fonts.end())
+		{
+			iterator->second->references++;
+
+			return iterator->second;
+		}
+
+		FontAsset* asset = new FontAsset();
+		asset->key = key;
+		asset->path = path;
+		asset->rasterSize = rasterSize;
+		asset->font = new Font(path, rasterSize);
+		asset->references = 1;
+
+		Fonts[key] = asset;
+
+		return asset;
+	}
+
+	void Release(FontAsset* asset)
+	{
+		if (!asset || --asset->references > 0)
+		{
+			return;
+		}
+
+		delete asset->font;
+
+		Fonts.erase(asset->key);
+
+		delete asset;
+	}
+
+	void PreloadShaderPermutations(const char* vertexShaderPath, const char* fragmentShaderPath, const std::vector<std::string>& features)
+	{
+		for (const std::vector<std::string>& defines : Renderer::GetShaderPermutations(features))
+		{
+			PreloadedShaders.push_back(AcquireShader(vertexShaderPath, fragmentShaderPath, defines));
+		}
+	}
+
+	void ReleasePreloadedShaders()
+	{
+		for (ShaderAsset* asset : PreloadedShaders)
+		{
+			Release(asset);
+		}
+
+		PreloadedShaders.clear();
+	}
+
+	size_t GetTexture2DCount()
+	{
+		return Textures.size();
+	}
+
+	size_t GetShaderCount()
+	{
+		return Shaders.size();
+	}
+
+	size_t GetFontCount()
+	{
+		return Fonts.size();
+	}
+}
\ No newline at end of file
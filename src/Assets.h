@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Types.h"
+#include "Sampler.h"
+
+namespace Velkro
+{
+	class Font;
+}
+
+namespace Velkro::Assets
+{
+	// Shared GPU resources, every component loading the same path with the same parameters gets the same entry.
+	// Components hold a reference and read the ID through it, so the entry can be updated in place once streaming finishes.
+	struct Texture2DAsset
+	{
+		std::string key;
+		std::string path;
+
+		Sampler sampler;
+
+		uint32_t ID = 0;
+
+		int width = 0, height = 0, channels = 0;
+
+		uint32_t streamRequest = 0;
+		uint32_t reloadRequest = 0; // Replacement streaming in after the file changed.
+
+		int references = 0;
+
+		bool generated = false; // Built at runtime rather than loaded from path, so there is no file to watch.
+
+		bool IsLoaded() const
+		{
+			return ID != 0 && streamRequest == 0;
+		}
+	};
+
+	struct ShaderAsset
+	{
+		std::string key;
+		std::string vertexPath, fragmentPath; // Fragment path is empty for cooked shaders.
+		std::vector<std::string> defines;
+
+		uint32_t ID = 0;
+		uint32_t pendingID = 0; // Replacement compiling after a source file changed.
+
+		int references = 0;
+
+		bool IsLoaded() const; // True once the program has linked.
+	};
+
+	struct FontAsset
+	{
+		std::string key;
+		std::string path;
+
+		float rasterSize = 0.0f;
+
+		Font* font = nullptr;
+
+		int references = 0;
+	};
+
+	// Acquire loads the asset on first use and adds a reference, Release frees the GL object once the last reference is gone.
+	// Both are main thread only, like the components that use them.
+	Texture2DAsset* AcquireTexture2D(const char* path, const Sampler& sampler, bool async);
+	void Release(Texture2DAsset* asset);
+
+	// Takes ownership of a texture created at runtime, like an atlas page, so components can share it like any loaded texture.
+	// The name only has to be unique, the asset starts with one reference held by the caller.
+	Texture2DAsset* AddTexture2D(const std::string& name, uint32_t textureID, int width, int height, int channels);
+
+	ShaderAsset* AcquireShader(const char* vertexShaderPath, const char* fragmentShaderPath, const std::vector<std::string>& defines = {}); // Pass nullptr as the fragment path for cooked shaders.
+	void Release(ShaderAsset* asset);
+
+	// Fonts are cached by path and raster size, glyphs are cached inside the font as they are first used.
+	FontAsset* AcquireFont(const char* path, float rasterSize = 48.0f);
+	void Release(FontAsset* asset);
+
+	// Submits every permutation of the features at once so later AcquireShader calls find them compiled, they stay loaded until ReleasePreloadedShaders.
+	void PreloadShaderPermutations(const char* vertexShaderPath, const char* fragmentShaderPath, const std::vector<std::string>& features);
+	void ReleasePreloadedShaders();
+
+	// Watches the files of every loaded asset and rebuilds only the assets whose files change. Textures decode on a job thread,
+	// shaders compile in the background, and the new GL object replaces the old one at a frame boundary.
+	// Shader reloads need the context on the main thread, so they are skipped while the frame pipeline runs.
+	void SetHotReload(bool enabled);
+	bool IsHotReloadEnabled();
+	void UpdateHotReload(); // Called by the engine once per frame.
+
+	std::string NormalizePath(const char* path);
+
+	size_t GetTexture2DCount();
+	size_t GetShaderCount();
+	size_t GetFontCount();
+}
\ No newline at end of file
@@ -0,0 +1,315 @@
+#include "AtlasBuilder.h"
+
+#include <glad/glad.h>
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <numeric>
+
+#include "Assets.h"
+#include "Renderer.h"
+#include "FramePipeline.h"
+#include "IO.h"
+#include "Image.h"
+#include "Log.h"
+
+namespace Velkro
+{
+	static constexpr int PlacementAlignment = 4; // Keeps images on 4x4 blocks, so they stay apart in the first two mip levels.
+
+	static int Align(int value)
+	{
+		return (value + PlacementAlignment - 1) / PlacementAlignment * PlacementAlignment;
+	}
+
+	AtlasBuilder::AtlasBuilder(int pageWidth, int pageHeight, int padding)
+		: m_PageWidth(pageWidth), m_PageHeight(pageHeight), m_Padding(padding)
+	{
+	}
+
+	AtlasBuilder::~AtlasBuilder()
+	{
+		for (Assets::Texture2DAsset* page : m_Pages)
+		{
+			Assets::Release(page);
+		}
+	}
+
+	int AtlasBuilder::Add(const char* imagePath)
+	{
+		IO::FileView file = IO::MapFile(imagePath);
+
+		int width, height, channels;
+		uint8_t* pixels = file.IsOpen() ? stbi_load_from_memory(file.GetPointer(), static_cast<int>(file.GetSize()), &width, &height, &channels, STBI_rgb_alpha) : nullptr;
+
+		if (!pixels)
+		{
+			VLK_CORE_ERROR("AtlasBuilder: Failed to load \"{}\".", imagePath);
+
+			return -1;
+		}
+
+		int index = Add(pixels, width, height);
+
+		stbi_image_free(pixels);
+
+		return index;
+	}
+
+	int AtlasBuilder::Add(const uint8_t* pixels, int width, int height)
+	{
+		if (width <= 0 || height <= 0)
+		{
+			VLK_CORE_ERROR("AtlasBuilder: {}x{} image is empty.", width, height);
+
+			return -1;
+		}
+
+		// Checked against the aligned size Build places, the first comparison keeps the sum from overflowing.
+		if (width > m_PageWidth || height > m_PageHeight || Align(width + m_Padding * 2) > m_PageWidth || Align(height + m_Padding * 2) > m_PageHeight)
+		{
+			VLK_CORE_ERROR("AtlasBuilder: {}x{} image doesn't fit on a {}x{} page.", width, height, m_PageWidth, m_PageHeight);
+
+			return -1;
+		}
+
+		Source& source = m_Images.emplace_back();
+		source.pixels.assign(pixels, pixels + static_cast<size_t>(width) * height * 4);
+		source.width = width;
+		source.height = height;
+
+		return static_cast<int>(m_Images.size() - 1);
+	}
+
+	bool AtlasBuilder::m_Fit(const std::vector<SkylineNode>& skyline, size_t index, int width, int height, int& y) const
+	{
+		int x = skyline[index].x;
+
+		if (x + width > m_PageWidth)
+		{
+			return false;
+		}
+
+		y = skyline[index].y;
+
+		for (int widthLeft = width; widthLeft > 0; index++)
+		{
+			y = std::max(y, skyline[index].y);
+
+			if (y + height > m_PageHeight)
+			{
+				return false;
+			}
+
+			widthLeft -= skyline[index].width;
+		}
+
+		return true;
+	}
+
+	// Bottom left rule, picks the spot where the top of the image ends up lowest.
+	bool AtlasBuilder::m_Place(std::vector<SkylineNode>& skyline, int width, int height, int& x, int& y) const
+	{
+		size_t bestIndex = skyline.size();
+		int bestTop = m_PageHeight + 1;
+		int bestWidth = m_PageWidth + 1;
+
+		for (size_t i = 0; i < skyline.size(); i++)
+		{
+			int fitY;
+
+			if (m_Fit(skyline, i, width, height, fitY) && (fitY + height < bestTop || (fitY + height == bestTop && skyline[i].width < bestWidth)))
+			{
+				bestIndex = i;
+				bestTop = fitY + height;
+				bestWidth = skyline[i].width;
+
+				y = fitY;
+			}
+		}
+
+		if (bestIndex == skyline.size())
+		{
+			return false;
+		}
+
+		x = skyline[bestIndex].x;
+
+		skyline.insert(skyline.begin() + bestIndex, { x, y + height, width });
+
+		// Shrink or remove the nodes now underneath the new one.
+		for (size_t i = bestIndex + 1; i < skyline.size(); i++)
+		{
+			SkylineNode& previous = skyline[i - 1];
+			SkylineNode& node = skyline[i];
+
+			int overlap = previous.x + previous.width - node.x;
+
+			if (overlap <= 0)
+			{
+				break;
+			}
+
+			node.x += overlap;
+			node.width -= overlap;
+
+			if (node.width > 0)
+			{
+				break;
+			}
+
+			skyline.erase(skyline.begin() + i);
+			i--;
+		}
+
+		for (size_t i = 0; i + 1 < skyline.size();)
+		{
+			if (skyline[i].y == skyline[i + 1].y)
+			{
+				skyline[i].width += skyline[i + 1].width;
+				skyline.erase(skyline.begin() + i + 1);
+			}
+			else
+			{
+				i++;
+			}
+		}
+
+		return true;
+	}
+
+	// Copies the image with its gutter, each gutter pixel repeats the nearest edge pixel.
+	void AtlasBuilder::m_Blit(std::vector<uint8_t>& page, const Source& source, int x, int y) const
+	{
+		for (int row = -m_Padding; row < source.height + m_Padding; row++)
+		{
+			int sourceRow = std::clamp(row, 0, source.height - 1);
+
+			uint8_t* destination = page.data() + (static_cast<size_t>(y + m_Padding + row) * m_PageWidth + x) * 4;
+			const uint8_t* pixels = source.pixels.data() + static_cast<size_t>(sourceRow) * source.width * 4;
+
+			for (int column = 0; column < m_Padding; column++)
+			{
+				std::memcpy(destination + column * 4, pixels, 4);
+				std::memcpy(destination + (m_Padding + source.width + column) * 4, pixels + (source.width - 1) * 4, 4);
+			}
+
+			std::memcpy(destination + m_Padding * 4, pixels, static_cast<size_t>(source.width) * 4);
+		}
+	}
+
+	bool AtlasBuilder::Build(const Sampler& sampler)
+	{
+		if (FramePipeline::IsRunning())
+		{
+			VLK_CORE_ERROR("AtlasBuilder: Built while the frame pipeline owns the GL context, build it before the pipeline starts.");
+
+			return false;
+		}
+
+		for (Assets::Texture2DAsset* page : m_Pages)
+		{
+			Assets::Release(page);
+		}
+
+		m_Pages.clear();
+
+		m_UVs.assign(m_Images.size(), UVRect());
+
+		// Tallest first packs a skyline tightest.
+		std::vector<size_t> order(m_Images.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) { return m_Images[a].height > m_Images[b].height; });
+
+		std::vector<bool> packed(m_Images.size(), false);
+		size_t packedCount = 0;
+
+		static int AtlasCount = 0;
+		int atlas = AtlasCount++;
+
+		while (packedCount < m_Images.size())
+		{
+			int page = static_cast<int>(m_Pages.size());
+
+			std::vector<SkylineNode> skyline = { { 0, 0, m_PageWidth } };
+			std::vector<uint8_t> pixels(static_cast<size_t>(m_PageWidth) * m_PageHeight * 4, 0);
+
+			size_t packedOnPage = 0;
+
+			for (size_t index : order)
+			{
+				if (packed[index])
+				{
+					continue;
+				}
+
+				const Source& source = m_Images[index];
+
+				int x, y;
+
+				if (!m_Place(skyline, Align(source.width + m_Padding * 2), Align(source.height + m_Padding * 2), x, y))
+				{
+					continue;
+				}
+
+				m_Blit(pixels, source, x, y);
+
+				UVRect& uv = m_UVs[index];
+				uv.uMin = static_cast<float>(x + m_Padding) / m_PageWidth;
+				uv.vMin = static_cast<float>(y + m_Padding) / m_PageHeight;
+				uv.uMax = static_cast<float>(x + m_Padding + source.width) / m_PageWidth;
+				uv.vMax = static_cast<float>(y + m_Padding + source.height) / m_PageHeight;
+				uv.page = page;
+
+				packed[index] = true;
+				packedCount++;
+				packedOnPage++;
+			}
+
+			if (packedOnPage == 0)
+			{
+				VLK_CORE_ERROR("AtlasBuilder: Failed to pack images.");
+
+				return false;
+			}
+
+			Image::ImageData image;
+			image.internalFormat = GL_RGBA8;
+			image.format = GL_RGBA;
+			image.width = m_PageWidth;
+			image.height = m_PageHeight;
+			image.levels.push_back({ 0, pixels.size(), m_PageWidth, m_PageHeight });
+			image.pixels = std::move(pixels);
+
+			uint32_t textureID = Renderer::CreateTexture2D(image, sampler);
+
+			m_Pages.push_back(Assets::AddTexture2D(std::format("atlas{}/page{}", atlas, page), textureID, m_PageWidth, m_PageHeight, 4));
+		}
+
+		VLK_CORE_INFO("AtlasBuilder: Packed {} images into {} pages.", m_Images.size(), m_Pages.size());
+
+		return true;
+	}
+
+	const UVRect& AtlasBuilder::GetUV(int image) const
+	{
+		return m_UVs[image];
+	}
+
+	const std::vector<UVRect>& AtlasBuilder::GetUVs() const
+	{
+		return m_UVs;
+	}
+
+	int AtlasBuilder::GetPageCount() const
+	{
+		return static_cast<int>(m_Pages.size());
+	}
+
+	Assets::Texture2DAsset* AtlasBuilder::GetPage(int page) const
+	{
+		return m_Pages[page];
+	}
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Types.h"
+#include "Sampler.h"
+
+namespace Velkro
+{
+	namespace Assets
+	{
+		struct Texture2DAsset;
+	}
+
+	struct UVRect
+	{
+		float uMin, vMin, uMax, vMax;
+
+		int page;
+	};
+
+	// Packs images of any size into as few atlas pages as possible with a skyline packer, so sprites using them share one texture bind.
+	// Every image is surrounded by a gutter of its own edge pixels, which keeps filtering and the first mip levels from bleeding
+	// in neighbouring images. Pages are created on Build and live in the asset cache as long as something uses them.
+	class AtlasBuilder
+	{
+	public:
+		AtlasBuilder(int pageWidth = 2048, int pageHeight = 2048, int padding = 4);
+		~AtlasBuilder();
+
+		int Add(const char* imagePath); // Returns the image's index, or -1 if it couldn't be loaded.
+		int Add(const uint8_t* pixels, int width, int height); // RGBA8, bottom row first like images loaded through stb.
+
+		bool Build(const Sampler& sampler = Sampler());
+
+		const UVRect& GetUV(int image) const;
+		const std::vector<UVRect>& GetUVs() const;
+
+		int GetPageCount() const;
+		Assets::Texture2DAsset* GetPage(int page) const;
+
+	private:
+		struct Source
+		{
+			std::vector<uint8_t> pixels;
+			int width, height;
+		};
+
+		struct SkylineNode
+		{
+			int x, y, width;
+		};
+
+		bool m_Fit(const std::vector<SkylineNode>& skyline, size_t index, int width, int height, int& y) const;
+		bool m_Place(std::vector<SkylineNode>& skyline, int width, int height, int& x, int& y) const;
+
+		void m_Blit(std::vector<uint8_t>& page, const Source& source, int x, int y) const;
+
+		int m_PageWidth, m_PageHeight;
+		int m_Padding;
+
+		std::vector<Source> m_Images;
+		std::vector<UVRect> m_UVs;
+
+		std::vector<Assets::Texture2DAsset*> m_Pages;
+	};
+}
\ No newline at end of file
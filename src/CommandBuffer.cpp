@@ -0,0 +1,476 @@
+#include "CommandBuffer.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+
+#include "Window.h"
+#include "Log.h"
+
+namespace Velkro
+{
+	enum CommandType : uint16_t
+	{
+		ClearCommandType, ViewportCommandType, UniformMat4CommandType, UniformVec3CommandType, UploadBufferCommandType, UploadTextureCommandType, DrawCommandType, DrawElementsCommandType, MultiDrawElementsIndirectCommandType, CallCommandType, PresentCommandType
+	};
+
+	// Every command starts with a header, followed by the command and its payload, padded so the next header stays aligned.
+	struct CommandHeader
+	{
+		uint16_t type;
+		uint32_t size;
+	};
+
+	struct ViewportCommand
+	{
+		int x, y, width, height;
+	};
+
+	struct UniformCommand
+	{
+		uint32_t programID;
+		float values[16];
+	};
+
+	struct UploadBufferCommand
+	{
+		uint32_t target, bufferID;
+		size_t offset, size;
+	};
+
+	struct UploadTextureCommand
+	{
+		uint32_t textureID;
+		int x, y, width, height;
+	};
+
+	struct DrawCommand
+	{
+		uint32_t vertexArray, vertexBuffer, elementBuffer;
+		uint32_t programID, textureID;
+
+		size_t verticesSize, indexCount;
+	};
+
+	struct DrawElementsCommand
+	{
+		uint32_t vertexArray, programID, textureID;
+		uint32_t shortIndices;
+
+		size_t indexCount, indexOffset;
+	};
+
+	struct MultiDrawElementsIndirectCommand
+	{
+		uint32_t vertexArray, programID, textureID;
+		uint32_t indirectBuffer, storageBuffer;
+		uint32_t parameterBuffer; // 0 for a draw count given on record.
+
+		size_t indirectOffset, drawCount;
+		size_t storageOffset, storageSize;
+		size_t parameterOffset;
+	};
+
+	struct CallCommand
+	{
+		void (*function)(void* userData);
+		void* userData;
+	};
+
+	struct PresentCommand
+	{
+		Window* window;
+	};
+
+	static constexpr size_t CommandAlignment = alignof(std::max_align_t);
+
+	static constexpr size_t AlignCommandSize(size_t size)
+	{
+		return (size + CommandAlignment - 1) & ~(CommandAlignment - 1);
+	}
+
+	static std::mutex FlushedMutex;
+	static CommandBuffer FlushedCommands;
+
+	// Draw buffers start small, batches that outgrow them get a larger store. The old contents don't matter, every draw overwrites them.
+	static void GrowBuffer(uint32_t target, size_t size)
+	{
+		GLint bufferSize = 0;
+		glGetBufferParameteriv(target, GL_BUFFER_SIZE, &bufferSize);
+
+		if (size > static_cast<size_t>(bufferSize))
+		{
+			glBufferData(target, static_cast<GLsizeiptr>(std::max(size, static_cast<size_t>(bufferSize) * 2)), nullptr, GL_DYNAMIC_DRAW);
+		}
+	}
+
+	void* CommandBuffer::m_Record(uint16_t type, size_t commandSize, size_t payloadSize, void** payload)
+	{
+		size_t headerSize = AlignCommandSize(sizeof(CommandHeader));
+		size_t size = AlignCommandSize(headerSize + AlignCommandSize(commandSize) + payloadSize);
+
+		size_t offset = m_Bytes.size();
+
+		m_Bytes.resize(offset + size);
+
+		uint8_t* bytes = m_Bytes.data() + offset;
+
+		CommandHeader* header = reinterpret_cast<CommandHeader*>(bytes);
+		header->type = type;
+		header->size = static_cast<uint32_t>(size);
+
+		if (payload)
+		{
+			*payload = bytes + headerSize + AlignCommandSize(commandSize);
+		}
+
+		return bytes + headerSize;
+	}
+
+	void CommandBuffer::Clear()
+	{
+		m_Record(ClearCommandType, 0, 0, nullptr);
+	}
+
+	void CommandBuffer::SetViewport(int x, int y, int width, int height)
+	{
+		ViewportCommand* command = static_cast<ViewportCommand*>(m_Record(ViewportCommandType, sizeof(ViewportCommand), 0, nullptr));
+
+		*command = { x, y, width, height };
+	}
+
+	void CommandBuffer::SetUniformMat4(uint32_t programID, const char* name, const float* mat4)
+	{
+		size_t nameSize = std::strlen(name) + 1;
+
+		void* payload;
+
+		UniformCommand* command = static_cast<UniformCommand*>(m_Record(UniformMat4CommandType, sizeof(UniformCommand), nameSize, &payload));
+		command->programID = programID;
+
+		std::memcpy(command->values, mat4, 16 * sizeof(float));
+		std::memcpy(payload, name, nameSize);
+	}
+
+	void CommandBuffer::SetUniformVec3(uint32_t programID, const char* name, const float* vec3)
+	{
+		size_t nameSize = std::strlen(name) + 1;
+
+		void* payload;
+
+		UniformCommand* command = static_cast<UniformCommand*>(m_Record(UniformVec3CommandType, sizeof(UniformCommand), nameSize, &payload));
+		command->programID = programID;
+
+		std::memcpy(command->values, vec3, 3 * sizeof(float));
+		std::memcpy(payload, name, nameSize);
+	}
+
+	void CommandBuffer::UploadBuffer(uint32_t target, uint32_t bufferID, size_t offset, const void* data, size_t size)
+	{
+		void* payload;
+
+		UploadBufferCommand* command = static_cast<UploadBufferCommand*>(m_Record(UploadBufferCommandType, sizeof(UploadBufferCommand), size, &payload));
+
+		*command = { target, bufferID, offset, size };
+
+		std::memcpy(payload, data, size);
+	}
+
+	void* CommandBuffer::UploadBuffer(uint32_t target, uint32_t bufferID, size_t offset, size_t size)
+	{
+		void* payload;
+
+		UploadBufferCommand* command = static_cast<UploadBufferCommand*>(m_Record(UploadBufferCommandType, sizeof(UploadBufferCommand), size, &payload));
+
+		*command = { target, bufferID, offset, size };
+
+		return payload;
+	}
+
+	void CommandBuffer::UploadTexture(uint32_t textureID, int x, int y, int width, int height, const void* pixels)
+	{
+		size_t size = static_cast<size_t>(width) * height * 4;
+
+		void* payload;
+
+		UploadTextureCommand* command = static_cast<UploadTextureCommand*>(m_Record(UploadTextureCommandType, sizeof(UploadTextureCommand), size, &payload));
+
+		*command = { textureID, x, y, width, height };
+
+		std::memcpy(payload, pixels, size);
+	}
+
+	void CommandBuffer::Draw(uint32_t vertexArray, uint32_t vertexBuffer, uint32_t elementBuffer, uint32_t programID, uint32_t textureID, const void* vertices, size_t verticesSize, const uint32_t* indices, size_t indexCount)
+	{
+		size_t indicesSize = indexCount * sizeof(uint32_t);
+
+		void* payload;
+
+		DrawCommand* command = static_cast<DrawCommand*>(m_Record(DrawCommandType, sizeof(DrawCommand), AlignCommandSize(verticesSize) + indicesSize, &payload));
+
+		*command = { vertexArray, vertexBuffer, elementBuffer, programID, textureID, verticesSize, indexCount };
+
+		std::memcpy(payload, vertices, verticesSize);
+		std::memcpy(static_cast<uint8_t*>(payload) + AlignCommandSize(verticesSize), indices, indicesSize);
+	}
+
+	void CommandBuffer::DrawElements(uint32_t vertexArray, uint32_t programID, uint32_t textureID, size_t indexCount, size_t indexOffset, bool shortIndices)
+	{
+		DrawElementsCommand* command = static_cast<DrawElementsCommand*>(m_Record(DrawElementsCommandType, sizeof(DrawElementsCommand), 0, nullptr));
+
+		*command = { vertexArray, programID, textureID, shortIndices ? 1u : 0u, indexCount, indexOffset };
+	}
+
+	void CommandBuffer::MultiDrawElementsIndirect(uint32_t vertexArray, uint32_t programID, uint32_t textureID, uint32_t indirectBuffer, size_t indirectOffset, size_t drawCount, uint32_t storageBuffer, size_t storageOffset, size_t storageSize)
+	{
+		MultiDrawElementsIndirectCommand* command = static_cast<MultiDrawElementsIndirectCommand*>(m_Record(MultiDrawElementsIndirectCommandType, sizeof(MultiDrawElementsIndirectCommand), 0, nullptr));
+
+		*command = { vertexArray, programID, textureID, indirectBuffer, storageBuffer, 0, indirectOffset, drawCount, storageOffset, storageSize, 0 };
+	}
+
+	void CommandBuffer::MultiDrawElementsIndirectCount(uint32_t vertexArray, uint32_t programID, uint32_t textureID, uint32_t indirectBuffer, size_t indirectOffset, size_t maxDrawCount, uint32_t parameterBuffer, size_t parameterOffset, uint32_t storageBuffer, size_t storageOffset, size_t storageSize)
+	{
+		MultiDrawElementsIndirectCommand* command = static_cast<MultiDrawElementsIndirectCommand*>(m_Record(MultiDrawElementsIndirectCommandType, sizeof(MultiDrawElementsIndirectCommand), 0, nullptr));
+
+		*command = { vertexArray, programID, textureID, indirectBuffer, storageBuffer, parameterBuffer, indirectOffset, maxDrawCount, storageOffset, storageSize, parameterOffset };
+	}
+
+	void CommandBuffer::Call(void (*function)(void* userData), void* userData)
+	{
+		CallCommand* command = static_cast<CallCommand*>(m_Record(CallCommandType, sizeof(CallCommand), 0, nullptr));
+
+		*command = { function, userData };
+	}
+
+	void CommandBuffer::Present(Window* window)
+	{
+		PresentCommand* command = static_cast<PresentCommand*>(m_Record(PresentCommandType, sizeof(PresentCommand), 0, nullptr));
+
+		command->window = window;
+	}
+
+	void CommandBuffer::Append(const CommandBuffer& commandBuffer)
+	{
+		m_Bytes.insert(m_Bytes.end(), commandBuffer.m_Bytes.begin(), commandBuffer.m_Bytes.end());
+	}
+
+	void CommandBuffer::Execute() const
+	{
+		size_t headerSize = AlignCommandSize(sizeof(CommandHeader));
+
+		const uint8_t* bytes = m_Bytes.data();
+		const uint8_t* end = bytes + m_Bytes.size();
+
+		while (bytes < end)
+		{
+			const CommandHeader* header = reinterpret_cast<const CommandHeader*>(bytes);
+			const uint8_t* data = bytes + headerSize;
+
+			switch (header->type)
+			{
+			case ClearCommandType:
+			{
+				glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+				break;
+			}
+			case ViewportCommandType:
+			{
+				const ViewportCommand* command = reinterpret_cast<const ViewportCommand*>(data);
+
+				glViewport(command->x, command->y, command->width, command->height);
+				break;
+			}
+			case UniformMat4CommandType:
+			case UniformVec3CommandType:
+			{
+				const UniformCommand* command = reinterpret_cast<const UniformCommand*>(data);
+				const char* name = reinterpret_cast<const char*>(data + AlignCommandSize(sizeof(UniformCommand)));
+
+				GLint location = glGetUniformLocation(command->programID, name);
+
+				if (header->type == UniformMat4CommandType)
+				{
+					glProgramUniformMatrix4fv(command->programID, location, 1, GL_FALSE, command->values);
+				}
+				else
+				{
+					glProgramUniform3f(command->programID, location, command->values[0], command->values[1], command->values[2]);
+				}
+				break;
+			}
+			case UploadBufferCommandType:
+			{
+				const UploadBufferCommand* command = reinterpret_cast<const UploadBufferCommand*>(data);
+
+				glBindBuffer(command->target, command->bufferID);
+				glBufferSubData(command->target, command->offset, command->size, data + AlignCommandSize(sizeof(UploadBufferCommand)));
+				glBindBuffer(command->target, 0);
+				break;
+			}
+			case UploadTextureCommandType:
+			{
+				const UploadTextureCommand* command = reinterpret_cast<const UploadTextureCommand*>(data);
+
+				glTextureSubImage2D(command->textureID, 0, command->x, command->y, command->width, command->height, GL_RGBA, GL_UNSIGNED_BYTE, data + AlignCommandSize(sizeof(UploadTextureCommand)));
+				break;
+			}
+			case DrawCommandType:
+			{
+				const DrawCommand* command = reinterpret_cast<const DrawCommand*>(data);
+				const uint8_t* vertices = data + AlignCommandSize(sizeof(DrawCommand));
+				const uint8_t* indices = vertices + AlignCommandSize(command->verticesSize);
+
+				size_t indicesSize = command->indexCount * sizeof(uint32_t);
+
+				glBindBuffer(GL_ARRAY_BUFFER, command->vertexBuffer);
+				GrowBuffer(GL_ARRAY_BUFFER, command->verticesSize);
+				glBufferSubData(GL_ARRAY_BUFFER, 0, command->verticesSize, vertices);
+
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, command->elementBuffer);
+				GrowBuffer(GL_ELEMENT_ARRAY_BUFFER, indicesSize);
+				glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indicesSize, indices);
+
+				glUseProgram(command->programID);
+
+				glBindTexture(GL_TEXTURE_2D, command->textureID);
+
+				glBindVertexArray(command->vertexArray);
+				glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(command->indexCount), GL_UNSIGNED_INT, 0);
+				glBindVertexArray(0);
+				glBindTexture(GL_TEXTURE_2D, 0);
+				glUseProgram(0);
+
+				glBindBuffer(GL_ARRAY_BUFFER, 0);
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+				break;
+			}
+			case DrawElementsCommandType:
+			{
+				const DrawElementsCommand* command = reinterpret_cast<const DrawElementsCommand*>(data);
+
+				glUseProgram(command->programID);
+
+				glBindTexture(GL_TEXTURE_2D, command->textureID);
+
+				glBindVertexArray(command->vertexArray);
+				glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(command->indexCount), command->shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT, reinterpret_cast<const void*>(command->indexOffset));
+				glBindVertexArray(0);
+				glBindTexture(GL_TEXTURE_2D, 0);
+				glUseProgram(0);
+				break;
+			}
+			case MultiDrawElementsIndirectCommandType:
+			{
+				const MultiDrawElementsIndirectCommand* command = reinterpret_cast<const MultiDrawElementsIndirectCommand*>(data);
+
+				glUseProgram(command->programID);
+
+				glBindTexture(GL_TEXTURE_2D, command->textureID);
+
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command->indirectBuffer);
+				glBindBufferRange(GL_SHADER_STORAGE_BUFFER, 0, command->storageBuffer, command->storageOffset, command->storageSize);
+
+				glBindVertexArray(command->vertexArray);
+
+				if (command->parameterBuffer)
+				{
+					glBindBuffer(GL_PARAMETER_BUFFER, command->parameterBuffer);
+					glMultiDrawElementsIndirectCount(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(command->indirectOffset), static_cast<GLintptr>(command->parameterOffset), static_cast<GLsizei>(command->drawCount), 0);
+					glBindBuffer(GL_PARAMETER_BUFFER, 0);
+				}
+				else
+				{
+					glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<const void*>(command->indirectOffset), static_cast<GLsizei>(command->drawCount), 0);
+				}
+
+				glBindVertexArray(0);
+
+				glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+				glBindTexture(GL_TEXTURE_2D, 0);
+				glUseProgram(0);
+				break;
+			}
+			case CallCommandType:
+			{
+				const CallCommand* command = reinterpret_cast<const CallCommand*>(data);
+
+				command->function(command->userData);
+				break;
+			}
+			case PresentCommandType:
+			{
+				const PresentCommand* command = reinterpret_cast<const PresentCommand*>(data);
+
+				command->window->Update();
+				break;
+			}
+			default:
+			{
+				VLK_CORE_ERROR("Unknown render command type {}, skipping the rest of the buffer.", header->type);
+				return;
+			}
+			}
+
+			bytes += header->size;
+		}
+	}
+
+	void CommandBuffer::Reset()
+	{
+		m_Bytes.clear();
+	}
+
+	bool CommandBuffer::IsEmpty() const
+	{
+		return m_Bytes.empty();
+	}
+	size_t CommandBuffer::GetSize() const
+	{
+		return m_Bytes.size();
+	}
+
+	CommandBuffer& CommandBuffer::Get()
+	{
+		static thread_local CommandBuffer threadCommandBuffer;
+
+		return threadCommandBuffer;
+	}
+
+	void CommandBuffer::Flush()
+	{
+		CommandBuffer& commandBuffer = Get();
+
+		if (commandBuffer.IsEmpty())
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(FlushedMutex);
+
+		FlushedCommands.Append(commandBuffer);
+
+		commandBuffer.Reset();
+	}
+
+	void CommandBuffer::Collect(CommandBuffer& frame)
+	{
+		{
+			std::lock_guard<std::mutex> lock(FlushedMutex);
+
+			frame.Append(FlushedCommands);
+
+			FlushedCommands.Reset();
+		}
+
+		CommandBuffer& commandBuffer = Get();
+
+		frame.Append(commandBuffer);
+
+		commandBuffer.Reset();
+	}
+}
\ No newline at end of file
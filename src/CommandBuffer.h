@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Types.h"
+
+namespace Velkro
+{
+	class Window;
+
+	// Linear buffer of compact render commands, recorded on any thread and executed on the thread that owns the GL context.
+	class CommandBuffer
+	{
+	public:
+		CommandBuffer() = default;
+		~CommandBuffer() = default;
+
+		void Clear();
+		void SetViewport(int x, int y, int width, int height);
+
+		void SetUniformMat4(uint32_t programID, const char* name, const float* mat4);
+		void SetUniformVec3(uint32_t programID, const char* name, const float* vec3);
+
+		void UploadBuffer(uint32_t target, uint32_t bufferID, size_t offset, const void* data, size_t size);
+		void* UploadBuffer(uint32_t target, uint32_t bufferID, size_t offset, size_t size); // Returns the payload to be written in place, valid until the next command is recorded.
+		void UploadTexture(uint32_t textureID, int x, int y, int width, int height, const void* pixels); // RGBA8 pixels.
+
+		void Draw(uint32_t vertexArray, uint32_t vertexBuffer, uint32_t elementBuffer, uint32_t programID, uint32_t textureID, const void* vertices, size_t verticesSize, const uint32_t* indices, size_t indexCount);
+		void DrawElements(uint32_t vertexArray, uint32_t programID, uint32_t textureID, size_t indexCount, size_t indexOffset = 0, bool shortIndices = false); // Draws buffers already holding their data, nothing is uploaded. The offset is in bytes.
+		void MultiDrawElementsIndirect(uint32_t vertexArray, uint32_t programID, uint32_t textureID, uint32_t indirectBuffer, size_t indirectOffset, size_t drawCount, uint32_t storageBuffer, size_t storageOffset, size_t storageSize); // The storage range is bound to shader storage binding 0.
+		void MultiDrawElementsIndirectCount(uint32_t vertexArray, uint32_t programID, uint32_t textureID, uint32_t indirectBuffer, size_t indirectOffset, size_t maxDrawCount, uint32_t parameterBuffer, size_t parameterOffset, uint32_t storageBuffer, size_t storageOffset, size_t storageSize); // Takes the draw count from the parameter buffer, written on the GPU.
+
+		void Call(void (*function)(void* userData), void* userData); // Runs engine code that needs the GL context.
+
+		void Present(Window* window);
+
+		void Append(const CommandBuffer& commandBuffer);
+
+		void Execute() const;
+
+		void Reset();
+
+		bool IsEmpty() const;
+		size_t GetSize() const;
+
+		static CommandBuffer& Get(); // Buffer of the calling thread.
+
+		static void Flush(); // Hands the commands recorded on the calling thread to the next frame, worker threads call this when they finish recording.
+		static void Collect(CommandBuffer& frame); // Merges every flushed buffer, then the calling thread's buffer, into frame.
+
+	private:
+		void* m_Record(uint16_t type, size_t commandSize, size_t payloadSize, void** payload); // Helper function for recording, reserves space for a command and its payload.
+
+		std::vector<uint8_t> m_Bytes;
+	};
+}
\ No newline at end of file
@@ -1,8 +1,22 @@
 #include "Component.h"
 
 #include "Renderer.h"
-
+#include "Assets.h"
+#include "AtlasBuilder.h"
+#include "SpriteKernels.h"
+#include "Font.h"
+#include "Particles.h"
+#include "Culling.h"
+#include "MeshOptimizer.h"
+#include "FramePipeline.h"
+#include "Cooked.h"
+#include "IO.h"
+
+#include <algorithm>
+#include <cfloat>
 #include <chrono>
+#include <cstring>
+#include <numeric>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
@@ -19,6 +33,10 @@
 
 #include "Log.h"
 
+#include "CommandBuffer.h"
+
+#include <Velkro/Velkro.h>
+
 namespace Velkro
 {
 	class WindowComponent::Data
@@ -53,7 +71,7 @@ namespace Velkro
 
 	void WindowComponent::OnUpdate()
 	{
-		m_Window->Update();
+		CommandBuffer::Get().Present(m_Window);
 
 		Renderer::ClearBuffer();
 	}
@@ -92,8 +110,7 @@ namespace Velkro
 		std::string m_UUID;
 	};
 
-	ShaderComponent::ShaderComponent(const char* vertexShaderPath, const char* fragmentShaderPath)
-		: m_VertexShaderPath(vertexShaderPath), m_FragmentShaderPath(fragmentShaderPath)
+	ShaderComponent::ShaderComponent(const char* vertexShaderPath, const char* fragmentShaderPath, const std::vector<std::string>& defines)
 	{
 		m_Data = new Data();
 
@@ -103,30 +120,45 @@ namespace Velkro
 
 		m_Data->GetUUID() = uuid.GetUUIDString();
 
-		m_ID = Renderer::LoadShaderFromFile(m_VertexShaderPath, m_FragmentShaderPath);
+		m_Asset = Assets::AcquireShader(vertexShaderPath, fragmentShaderPath, defines);
 	}
 
-	void ShaderComponent::SetUniformMat4(const char* id, float* mat4)
+	ShaderComponent::ShaderComponent(const char* cookedShaderPath)
 	{
-		glUseProgram(m_ID);
+		m_Data = new Data();
+
+		UUID uuid;
+
+		uuid.GenerateUUID();
+
+		m_Data->GetUUID() = uuid.GetUUIDString();
 
-		glUniformMatrix4fv(glGetUniformLocation(m_ID, id), 1, GL_FALSE, mat4);
+		m_Asset = Assets::AcquireShader(cookedShaderPath, nullptr);
+	}
 
-		glUseProgram(0);
+	void ShaderComponent::SetUniformMat4(const char* id, float* mat4)
+	{
+		CommandBuffer::Get().SetUniformMat4(m_Asset->ID, id, mat4);
 	}
 
 	void ShaderComponent::SetUniformVec3(const char* id, vec3 vec3)
 	{
-		glUseProgram(m_ID);
+		CommandBuffer::Get().SetUniformVec3(m_Asset->ID, id, &vec3.x);
+	}
 
-		glUniform3f(glGetUniformLocation(m_ID, id), vec3.x, vec3.y, vec3.z);
+	void ShaderComponent::Bind()
+	{
+		glUseProgram(m_Asset->ID);
+	}
 
-		glUseProgram(0);
+	uint32_t ShaderComponent::GetID()
+	{
+		return m_Asset->ID;
 	}
 
-	void ShaderComponent::Bind()
+	bool ShaderComponent::IsLoaded()
 	{
-		glUseProgram(m_ID);
+		return m_Asset->IsLoaded();
 	}
 
 	const char* ShaderComponent::GetUUID()
@@ -142,7 +174,9 @@ namespace Velkro
 	}
 	void ShaderComponent::OnExit()
 	{
-		glDeleteProgram(m_ID);
+		Assets::Release(m_Asset);
+
+		m_Asset = nullptr;
 	}
 
 	class Texture2DComponent::Data
@@ -160,27 +194,64 @@ namespace Velkro
 		std::string m_UUID;
 	};
 	
-	Texture2DComponent::Texture2DComponent(const char* texturePath, bool linear)
+	Texture2DComponent::Texture2DComponent(const char* texturePath, bool linear, bool async)
+		: Texture2DComponent(texturePath, Sampler::FromLinear(linear), async)
+	{
+	}
+
+	Texture2DComponent::Texture2DComponent(const char* texturePath, const Sampler& sampler, bool async)
+	{
+		m_Data = new Data();
+
+		UUID uuid;
+
+		uuid.GenerateUUID();
+
+		m_Data->GetUUID() = uuid.GetUUIDString();
+
+		m_Asset = Assets::AcquireTexture2D(texturePath, sampler, async);
+	}
+
+	Texture2DComponent::Texture2DComponent(Assets::Texture2DAsset* asset)
 	{
-		m_ID = Renderer::LoadTexture2D(texturePath, m_Width, m_Height, m_Channels, linear);
+		m_Data = new Data();
+
+		UUID uuid;
+
+		uuid.GenerateUUID();
+
+		m_Data->GetUUID() = uuid.GetUUIDString();
+
+		m_Asset = asset;
+		m_Asset->references++;
 	}
 
 	void Texture2DComponent::Bind()
 	{
-		glBindTexture(GL_TEXTURE_2D, m_ID);
+		glBindTexture(GL_TEXTURE_2D, m_Asset->ID);
+	}
+
+	uint32_t Texture2DComponent::GetID()
+	{
+		return m_Asset->ID;
+	}
+
+	bool Texture2DComponent::IsLoaded()
+	{
+		return m_Asset->IsLoaded();
 	}
 
 	int Texture2DComponent::GetWidth()
 	{
-		return m_Width;
+		return m_Asset->width;
 	}
 	int Texture2DComponent::GetHeight()
 	{
-		return m_Height;
+		return m_Asset->height;
 	}
 	int Texture2DComponent::GetChannels()
 	{
-		return m_Channels;
+		return m_Asset->channels;
 	}
 
 	const char* Texture2DComponent::GetUUID()
@@ -196,6 +267,9 @@ namespace Velkro
 	}
 	void Texture2DComponent::OnExit()
 	{
+		Assets::Release(m_Asset);
+
+		m_Asset = nullptr;
 	}
 
 	class TextureAtlasComponent::Data
@@ -209,16 +283,71 @@ namespace Velkro
 			return m_UUID;
 		}
 
+		std::vector<UVRect>& GetUVs()
+		{
+			return m_UVs;
+		}
+
+		int& GetGridWidth()
+		{
+			return m_GridWidth;
+		}
+		int& GetGridHeight()
+		{
+			return m_GridHeight;
+		}
+
+		bool grid = true; // False for atlases packed by an AtlasBuilder, their rects are fixed.
+
 	private:
 		std::string m_UUID;
+
+		std::vector<UVRect> m_UVs; // One rect per texture ID, packed by an AtlasBuilder or cut from the tile grid.
+
+		int m_GridWidth = 0, m_GridHeight = 0; // Atlas size the grid rects were cut for.
 	};
 
 	TextureAtlasComponent::TextureAtlasComponent(const char* textureAtlasPath, bool linear, int textureWidth, int textureHeight)
+		: TextureAtlasComponent(textureAtlasPath, Sampler::FromLinear(linear), textureWidth, textureHeight)
+	{
+	}
+
+	TextureAtlasComponent::TextureAtlasComponent(const char* textureAtlasPath, const Sampler& sampler, int textureWidth, int textureHeight)
 		: m_TextureWidth(textureWidth), m_TextureHeight(textureHeight)
 	{
 		m_Data = new Data();
 
-		m_Atlas = new Texture2DComponent(textureAtlasPath, linear);
+		m_Atlas = new Texture2DComponent(textureAtlasPath, sampler);
+
+		// Cooked atlases carry their tile size.
+		if (m_TextureWidth <= 0 || m_TextureHeight <= 0)
+		{
+			Image::ReadCookedTileSize(textureAtlasPath, m_TextureWidth, m_TextureHeight);
+		}
+
+		if (m_TextureWidth <= 0 || m_TextureHeight <= 0)
+		{
+			VLK_CORE_ERROR("Texture atlas \"{}\" has no tile size, the whole image is used as texture 0.", textureAtlasPath);
+
+			m_TextureWidth = m_TextureHeight = 0;
+		}
+
+		UUID uuid;
+
+		uuid.GenerateUUID();
+
+		m_Data->GetUUID() = uuid.GetUUIDString();
+	}
+
+	TextureAtlasComponent::TextureAtlasComponent(AtlasBuilder* atlasBuilder, int page)
+		: m_TextureWidth(0), m_TextureHeight(0)
+	{
+		m_Data = new Data();
+
+		m_Atlas = new Texture2DComponent(atlasBuilder->GetPage(page));
+
+		m_Data->GetUVs() = atlasBuilder->GetUVs();
+		m_Data->grid = false;
 
 		UUID uuid;
 
@@ -232,29 +361,94 @@ namespace Velkro
 		m_Atlas->Bind();
 	}
 
-	void TextureAtlasComponent::GetUV(int textureID, float* UV)
+	void TextureAtlasComponent::m_UpdateGridUVs()
 	{
+		// Grid atlases are cut once per atlas size, which only changes when the texture is reloaded.
+		if (!m_Data->grid || !m_Atlas->IsLoaded() || (m_Data->GetGridWidth() == m_Atlas->GetWidth() && m_Data->GetGridHeight() == m_Atlas->GetHeight()))
+		{
+			return;
+		}
+
 		int atlasWidth = m_Atlas->GetWidth();
 		int atlasHeight = m_Atlas->GetHeight();
 
-		int tilesPerRow = atlasWidth / m_TextureWidth;
-		int tilesPerColumn = atlasHeight / m_TextureHeight;
+		// Without a tile size, or with one larger than the atlas, the whole image is a single tile.
+		int textureWidth = m_TextureWidth > 0 ? std::min(m_TextureWidth, atlasWidth) : atlasWidth;
+		int textureHeight = m_TextureHeight > 0 ? std::min(m_TextureHeight, atlasHeight) : atlasHeight;
+
+		int tilesPerRow = atlasWidth / textureWidth;
+		int tilesPerColumn = atlasHeight / textureHeight;
+
+		float tileWidth = static_cast<float>(textureWidth) / atlasWidth;
+		float tileHeight = static_cast<float>(textureHeight) / atlasHeight;
+
+		std::vector<UVRect>& rects = m_Data->GetUVs();
+
+		rects.resize(static_cast<size_t>(tilesPerRow) * tilesPerColumn);
+
+		for (int row = 0; row < tilesPerColumn; row++)
+		{
+			for (int column = 0; column < tilesPerRow; column++)
+			{
+				UVRect& rect = rects[row * tilesPerRow + column];
+				rect.uMin = column * tileWidth;
+				rect.uMax = rect.uMin + tileWidth;
+				rect.vMax = 1.0f - row * tileHeight;
+				rect.vMin = rect.vMax - tileHeight;
+				rect.page = 0;
+			}
+		}
+
+		m_Data->GetGridWidth() = atlasWidth;
+		m_Data->GetGridHeight() = atlasHeight;
+	}
+
+	void TextureAtlasComponent::GetUV(int textureID, float* UV)
+	{
+		// Streaming atlases show the whole placeholder until the real size is known.
+		if (!m_Atlas->IsLoaded())
+		{
+			UV[0] = 1.0f; UV[1] = 1.0f;
+			UV[2] = 1.0f; UV[3] = 0.0f;
+			UV[4] = 0.0f; UV[5] = 0.0f;
+			UV[6] = 0.0f; UV[7] = 1.0f;
+
+			return;
+		}
+
+		m_UpdateGridUVs();
+
+		std::vector<UVRect>& rects = m_Data->GetUVs();
+
+		if (textureID < 0 || textureID >= static_cast<int>(rects.size()))
+		{
+			VLK_CORE_ERROR("Texture ID {} is out of range for an atlas holding {} textures.", textureID, rects.size());
+
+			std::fill(UV, UV + 8, 0.0f);
+
+			return;
+		}
+
+		const UVRect& rect = rects[textureID];
+
+		UV[0] = rect.uMax; UV[1] = rect.vMax;
+		UV[2] = rect.uMax; UV[3] = rect.vMin;
+		UV[4] = rect.uMin; UV[5] = rect.vMin;
+		UV[6] = rect.uMin; UV[7] = rect.vMax;
+	}
 
-		float tileWidth = static_cast<float>(m_TextureWidth) / atlasWidth;
-		float tileHeight = static_cast<float>(m_TextureHeight) / atlasHeight;
+	int TextureAtlasComponent::GetTextureCount()
+	{
+		m_UpdateGridUVs();
 
-		int column = textureID % tilesPerRow;
-		int row = textureID / tilesPerRow;
+		return static_cast<int>(m_Data->GetUVs().size());
+	}
 
-		float uMin = column * tileWidth;
-		float uMax = uMin + tileWidth;
-		float vMax = 1.0f - row * tileHeight;
-		float vMin = vMax - tileHeight;
+	const UVRect* TextureAtlasComponent::GetUVs()
+	{
+		m_UpdateGridUVs();
 
-		UV[0] = uMax; UV[1] = vMax;
-		UV[2] = uMax; UV[3] = vMin;
-		UV[4] = uMin; UV[5] = vMin;
-		UV[6] = uMin; UV[7] = vMax;
+		return m_Data->GetUVs().data();
 	}
 
 	Texture2DComponent* TextureAtlasComponent::GetTexture()
@@ -423,7 +617,8 @@ namespace Velkro
 		delete m_Data;
 	}
 
-	class RenderComponent::Data
+	template<typename Layout>
+	class BasicRenderComponent<Layout>::Data
 	{
 	public:
 		std::vector<Vertex>& GetVertices()
@@ -445,7 +640,8 @@ namespace Velkro
 		std::string m_UUID;
 	};
 
-	RenderComponent::RenderComponent(WindowComponent* windowComponent, ShaderComponent* shaderComponent, Texture2DComponent* texture)
+	template<typename Layout>
+	BasicRenderComponent<Layout>::BasicRenderComponent(WindowComponent* windowComponent, ShaderComponent* shaderComponent, Texture2DComponent* texture)
 		: m_WindowComponent(windowComponent), m_ShaderComponent(shaderComponent), m_TextureComponent(texture)
 	{
 		m_Data = new Data();
@@ -474,20 +670,20 @@ namespace Velkro
 			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
 			glBufferData(GL_ELEMENT_ARRAY_BUFFER, maxIndices * sizeof(Index), m_Data->GetIndices().data(), GL_DYNAMIC_DRAW);
 
-			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-			glEnableVertexAttribArray(0);
-
-			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(3 * sizeof(float)));
-			glEnableVertexAttribArray(1);
+			for (uint32_t i = 0; i < Vertex::Attributes::count; i++)
+			{
+				const AttributeDescription& attribute = Vertex::Attributes::descriptions[i];
 
-			glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(6 * sizeof(float)));
-			glEnableVertexAttribArray(2);
+				glVertexAttribPointer(i, attribute.count, attribute.type, attribute.normalized ? GL_TRUE : GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(attribute.offset));
+				glEnableVertexAttribArray(i);
+			}
 		}
 
 		m_Initialized = true;
 	}
 
-	size_t RenderComponent::AddData(Vertex* vertices, size_t verticesCount, Index* indices, size_t indicesCount)
+	template<typename Layout>
+	size_t BasicRenderComponent<Layout>::AddData(Vertex* vertices, size_t verticesCount, Index* indices, size_t indicesCount)
 	{
 		size_t index = m_Data->GetVertices().size();
 
@@ -509,7 +705,8 @@ namespace Velkro
 		return index;
 	}
 
-	void RenderComponent::EditVertexData(size_t startIndex, Vertex* newVertices, size_t newVertexCount)
+	template<typename Layout>
+	void BasicRenderComponent<Layout>::EditVertexData(size_t startIndex, Vertex* newVertices, size_t newVertexCount)
 	{
 		if (startIndex + newVertexCount > m_Data->GetVertices().size())
 		{
@@ -520,40 +717,62 @@ namespace Velkro
 		{
 			m_Data->GetVertices()[startIndex + i] = newVertices[i];
 		}
+	}
+
+	template<typename Layout>
+	void BasicRenderComponent<Layout>::EditVertexUVs(size_t startIndex, const float* UVs, size_t vertexCount)
+	{
+		std::vector<Vertex>& vertices = m_Data->GetVertices();
 
-		glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-		glBufferSubData(GL_ARRAY_BUFFER, startIndex * sizeof(Vertex), newVertexCount * sizeof(Vertex), newVertices);
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			vertices[startIndex + i].SetUV(UVs[i * 2], UVs[i * 2 + 1]);
+		}
 	}
 
-	void RenderComponent::OnUpdate()
+	template<typename Layout>
+	typename BasicRenderComponent<Layout>::Vertex* BasicRenderComponent<Layout>::SetQuadCount(size_t quadCount)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, m_Data->GetVertices().size() * sizeof(Vertex), m_Data->GetVertices().data());		
+		std::vector<Index>& indices = m_Data->GetIndices();
+
+		size_t quadIndexCount = indices.size() / 2;
+
+		indices.resize(quadCount * 2);
+
+		for (size_t quad = quadIndexCount; quad < quadCount; quad++)
+		{
+			uint32_t first = static_cast<uint32_t>(quad * 4);
 
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
-		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, m_Data->GetIndices().size() * sizeof(Index), m_Data->GetIndices().data());
+			indices[quad * 2] = { first, first + 1, first + 3 };
+			indices[quad * 2 + 1] = { first + 1, first + 2, first + 3 };
+		}
 
-		m_ShaderComponent->Bind();
+		m_Data->GetVertices().resize(quadCount * 4);
 
-		m_TextureComponent->Bind();
+		return m_Data->GetVertices().data();
+	}
 
-		glBindVertexArray(m_VAO);
-		glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(m_Data->GetIndices().size()) * (sizeof(Index) / sizeof(uint32_t)), GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
-		glBindTexture(GL_TEXTURE_2D, 0);
-		glUseProgram(0);
+	template<typename Layout>
+	void BasicRenderComponent<Layout>::OnUpdate()
+	{
+		// Drawing with a program that is still linking would stall until the driver finishes it.
+		if (!m_ShaderComponent->IsLoaded())
+		{
+			return;
+		}
 
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		CommandBuffer::Get().Draw(m_VAO, m_VBO, m_EBO, m_ShaderComponent->GetID(), m_TextureComponent->GetID(), m_Data->GetVertices().data(), m_Data->GetVertices().size() * sizeof(Vertex), reinterpret_cast<uint32_t*>(m_Data->GetIndices().data()), m_Data->GetIndices().size() * (sizeof(Index) / sizeof(uint32_t)));
 	}
-	void RenderComponent::OnEvent(Event* event, WindowComponent* windowComponent)
+	template<typename Layout>
+	void BasicRenderComponent<Layout>::OnEvent(Event* event, WindowComponent* windowComponent)
 	{
 		if (WindowResizeEvent* resizeEvent = event->Get<WindowResizeEvent>())
 		{
 			Renderer::UpdateViewport(0, 0, resizeEvent->GetWidth(), resizeEvent->GetHeight());
 		}
 	}
-	void RenderComponent::OnExit()
+	template<typename Layout>
+	void BasicRenderComponent<Layout>::OnExit()
 	{
 		glDeleteBuffers(1, &m_VBO);
 		glDeleteBuffers(1, &m_EBO);
@@ -562,28 +781,181 @@ namespace Velkro
 		delete m_Data;
 	}
 
-	const char* RenderComponent::GetUUID()
+	template<typename Layout>
+	const char* BasicRenderComponent<Layout>::GetUUID()
 	{
 		return m_Data->GetUUID().c_str();
 	}
 
-	class SpriteComponent::Data
+	template class BasicRenderComponent<DefaultVertex>;
+	template class BasicRenderComponent<PackedVertex>;
+
+	struct MeshRange
+	{
+		size_t start, count;
+	};
+
+	// First fit allocation from a sorted list of free ranges, returns SIZE_MAX when nothing is large enough.
+	static size_t AllocateRange(std::vector<MeshRange>& freeRanges, size_t count)
+	{
+		for (size_t i = 0; i < freeRanges.size(); i++)
+		{
+			MeshRange& range = freeRanges[i];
+
+			if (range.count >= count)
+			{
+				size_t start = range.start;
+
+				range.start += count;
+				range.count -= count;
+
+				if (range.count == 0)
+				{
+					freeRanges.erase(freeRanges.begin() + i);
+				}
+
+				return start;
+			}
+		}
+
+		return SIZE_MAX;
+	}
+
+	static void FreeRange(std::vector<MeshRange>& freeRanges, size_t start, size_t count)
+	{
+		if (count == 0)
+		{
+			return;
+		}
+
+		std::vector<MeshRange>::iterator next = std::lower_bound(freeRanges.begin(), freeRanges.end(), start, [](const MeshRange& range, size_t value) { return range.start < value; });
+
+		next = freeRanges.insert(next, { start, count });
+
+		// Merges with the neighbours so freed meshes don't fragment the buffers for good.
+		if (next + 1 != freeRanges.end() && next->start + next->count == (next + 1)->start)
+		{
+			next->count += (next + 1)->count;
+
+			freeRanges.erase(next + 1);
+		}
+
+		if (next != freeRanges.begin() && (next - 1)->start + (next - 1)->count == next->start)
+		{
+			(next - 1)->count += next->count;
+
+			freeRanges.erase(next);
+		}
+	}
+
+	template<typename Layout>
+	class BasicMeshBatchComponent<Layout>::Data
 	{
 	public:
 		Data() = default;
 		~Data() = default;
 
+		struct Mesh
+		{
+			size_t firstVertex, verticesCount;
+			size_t firstIndex, indicesCount; // In triangles.
+
+			float sphere[4]; // Bounds for culling, centre and radius.
+
+			bool used;
+		};
+
+		struct QueuedDraw
+		{
+			uint64_t key; // Program in the high half, texture in the low half.
+
+			uint32_t mesh;
+
+			ShaderComponent* shaderComponent;
+
+			DrawData data;
+		};
+
+		// Laid out as glMultiDrawElementsIndirect reads it.
+		struct IndirectCommand
+		{
+			uint32_t count, instanceCount, firstIndex;
+			int32_t baseVertex;
+			uint32_t baseInstance;
+		};
+
 		std::string& GetUUID()
 		{
 			return m_UUID;
 		}
 
+		std::vector<Mesh>& GetMeshes()
+		{
+			return m_Meshes;
+		}
+		std::vector<uint32_t>& GetFreeMeshes()
+		{
+			return m_FreeMeshes;
+		}
+
+		std::vector<MeshRange>& GetFreeVertices()
+		{
+			return m_FreeVertices;
+		}
+		std::vector<MeshRange>& GetFreeIndices()
+		{
+			return m_FreeIndices;
+		}
+
+		std::vector<QueuedDraw>& GetQueuedDraws()
+		{
+			return m_QueuedDraws;
+		}
+		std::vector<uint32_t>& GetOrder()
+		{
+			return m_Order;
+		}
+
+		std::vector<IndirectCommand>& GetCommands()
+		{
+			return m_Commands;
+		}
+		std::vector<DrawData>& GetDrawData()
+		{
+			return m_DrawData;
+		}
+		std::vector<Culling::Candidate>& GetCandidates()
+		{
+			return m_Candidates;
+		}
+
+		Culling::Culler*& GetCuller()
+		{
+			return m_Culler;
+		}
+
 	private:
 		std::string m_UUID;
+
+		std::vector<Mesh> m_Meshes;
+		std::vector<uint32_t> m_FreeMeshes;
+
+		std::vector<MeshRange> m_FreeVertices;
+		std::vector<MeshRange> m_FreeIndices;
+
+		std::vector<QueuedDraw> m_QueuedDraws;
+		std::vector<uint32_t> m_Order; // Queued draws sorted by key, reused every frame.
+
+		std::vector<IndirectCommand> m_Commands;
+		std::vector<DrawData> m_DrawData;
+		std::vector<Culling::Candidate> m_Candidates;
+
+		Culling::Culler* m_Culler = nullptr;
 	};
 
-	SpriteComponent::SpriteComponent(WindowComponent* windowComponent, ShaderComponent* shaderComponent, Texture2DComponent* textureComponent, vec3 colour, float width, float height, float x, float y, float z)
-		: m_Width(width), m_Height(height), m_X(x), m_Y(y), m_Z(z)
+	template<typename Layout>
+	BasicMeshBatchComponent<Layout>::BasicMeshBatchComponent(size_t vertexCapacity, size_t indexCapacity, size_t drawCapacity)
+		: m_DrawCapacity(drawCapacity)
 	{
 		m_Data = new Data();
 
@@ -593,61 +965,863 @@ namespace Velkro
 
 		m_Data->GetUUID() = uuid.GetUUIDString();
 
-		m_RenderComponent = new RenderComponent(windowComponent, shaderComponent, textureComponent);
+		m_Data->GetFreeVertices().push_back({ 0, vertexCapacity });
+		m_Data->GetFreeIndices().push_back({ 0, indexCapacity });
 
-		std::vector<RenderComponent::Vertex> vertices =
-		{
-			{ RenderComponent::Vertex( 1.0f,  1.0f, 0.0f, colour.x, colour.y, colour.z, 1.0f, 1.0f) }, // top right
-			{ RenderComponent::Vertex( 1.0f, -1.0f, 0.0f, colour.x, colour.y, colour.z, 1.0f, 0.0f) }, // bottom right
-			{ RenderComponent::Vertex(-1.0f, -1.0f, 0.0f, colour.x, colour.y, colour.z, 0.0f, 0.0f) }, // bottom left
-			{ RenderComponent::Vertex(-1.0f,  1.0f, 0.0f, colour.x, colour.y, colour.z, 0.0f, 1.0f) }  // top left
-		};
+		glCreateBuffers(1, &m_VBO);
+		glNamedBufferStorage(m_VBO, vertexCapacity * sizeof(Vertex), nullptr, GL_DYNAMIC_STORAGE_BIT);
 
-		std::vector<RenderComponent::Index> indices =
+		glCreateBuffers(1, &m_EBO);
+		glNamedBufferStorage(m_EBO, indexCapacity * sizeof(Index), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+		glCreateBuffers(1, &m_IndirectBuffer);
+		glNamedBufferStorage(m_IndirectBuffer, drawCapacity * sizeof(typename Data::IndirectCommand), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+		glCreateBuffers(1, &m_DrawBuffer);
+		glNamedBufferStorage(m_DrawBuffer, drawCapacity * sizeof(DrawData), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+		glCreateVertexArrays(1, &m_VAO);
+		glVertexArrayVertexBuffer(m_VAO, 0, m_VBO, 0, sizeof(Vertex));
+		glVertexArrayElementBuffer(m_VAO, m_EBO);
+
+		for (uint32_t i = 0; i < Vertex::Attributes::count; i++)
 		{
-			{ RenderComponent::Index(0, 1, 3) },
-			{ RenderComponent::Index(1, 2, 3) }
-		};
+			const AttributeDescription& attribute = Vertex::Attributes::descriptions[i];
 
-		m_RenderComponent->AddData(vertices.data(), vertices.size(), indices.data(), indices.size());
+			glVertexArrayAttribFormat(m_VAO, i, attribute.count, attribute.type, attribute.normalized ? GL_TRUE : GL_FALSE, static_cast<uint32_t>(attribute.offset));
+			glVertexArrayAttribBinding(m_VAO, i, 0);
+			glEnableVertexArrayAttrib(m_VAO, i);
+		}
+
+		GLint storageAlignment = 1;
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+
+		m_DrawAlignment = static_cast<size_t>(storageAlignment) / std::gcd(static_cast<size_t>(storageAlignment), sizeof(DrawData));
 	}
 
-	SpriteComponent::SpriteComponent(WindowComponent* windowComponent, ShaderComponent* shaderComponent, TextureAtlasComponent* textureAtlasComponent, int textureID, vec3 colour, float width, float height, float x, float y, float z)
-		: m_TextureAtlasComponent(textureAtlasComponent), m_Width(width), m_Height(height), m_X(x), m_Y(y), m_Z(z), m_Colour(colour)
+	template<typename Layout>
+	uint32_t BasicMeshBatchComponent<Layout>::AddMesh(const Vertex* vertices, size_t verticesCount, const Index* indices, size_t indicesCount)
 	{
-		m_Data = new Data();
+		size_t firstVertex = AllocateRange(m_Data->GetFreeVertices(), verticesCount);
 
-		UUID uuid;
+		if (firstVertex == SIZE_MAX)
+		{
+			VLK_CORE_ERROR("Mesh batch is out of vertex space for a mesh of {} vertices.", verticesCount);
 
-		uuid.GenerateUUID();		
+			return InvalidMesh;
+		}
 
-		m_Data->GetUUID() = uuid.GetUUIDString();
+		size_t firstIndex = AllocateRange(m_Data->GetFreeIndices(), indicesCount);
 
-		m_RenderComponent = new RenderComponent(windowComponent, shaderComponent, textureAtlasComponent->GetTexture());
+		if (firstIndex == SIZE_MAX)
+		{
+			FreeRange(m_Data->GetFreeVertices(), firstVertex, verticesCount);
 
-		m_UV = new float[8];
+			VLK_CORE_ERROR("Mesh batch is out of index space for a mesh of {} triangles.", indicesCount);
 
-		m_TextureAtlasComponent->GetUV(textureID, m_UV);
+			return InvalidMesh;
+		}
 
-		std::vector<RenderComponent::Vertex> vertices =
+		uint32_t mesh;
+
+		if (!m_Data->GetFreeMeshes().empty())
 		{
-			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[0], m_UV[1]) }, // top right
-			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[2], m_UV[3]) }, // bottom right
-			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[4], m_UV[5]) }, // bottom left
-			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[6], m_UV[7]) }  // top left
-		};
+			mesh = m_Data->GetFreeMeshes().back();
+			m_Data->GetFreeMeshes().pop_back();
+		}
+		else
+		{
+			mesh = static_cast<uint32_t>(m_Data->GetMeshes().size());
+			m_Data->GetMeshes().emplace_back();
+		}
 
-		std::vector<RenderComponent::Index> indices =
+		typename Data::Mesh& added = m_Data->GetMeshes()[mesh];
+		added = { firstVertex, verticesCount, firstIndex, indicesCount, { 0.0f, 0.0f, 0.0f, 0.0f }, true };
+
+		if (verticesCount > 0)
 		{
-			{ RenderComponent::Index(0, 1, 3) },
-			{ RenderComponent::Index(1, 2, 3) }
-		};
+			glm::vec3 minimum(FLT_MAX), maximum(-FLT_MAX);
 
-		m_VerticesIndex = m_RenderComponent->AddData(vertices.data(), vertices.size(), indices.data(), indices.size());
-	}
+			for (size_t i = 0; i < verticesCount; i++)
+			{
+				glm::vec3 position;
+				vertices[i].GetPosition(position.x, position.y, position.z);
 
-	void SpriteComponent::TransformSprite(float width, float height, float x, float y, float z, vec3 colour, int textureID)
-	{
+				minimum = glm::min(minimum, position);
+				maximum = glm::max(maximum, position);
+			}
+
+			glm::vec3 centre = (minimum + maximum) * 0.5f;
+
+			float radius = 0.0f;
+
+			for (size_t i = 0; i < verticesCount; i++)
+			{
+				glm::vec3 position;
+				vertices[i].GetPosition(position.x, position.y, position.z);
+
+				radius = std::max(radius, glm::length(position - centre));
+			}
+
+			added.sphere[0] = centre.x;
+			added.sphere[1] = centre.y;
+			added.sphere[2] = centre.z;
+			added.sphere[3] = radius;
+		}
+
+		// Copy write keeps the uploads from touching the element buffer binding of whatever vertex array is bound.
+		CommandBuffer::Get().UploadBuffer(GL_COPY_WRITE_BUFFER, m_VBO, firstVertex * sizeof(Vertex), vertices, verticesCount * sizeof(Vertex));
+		CommandBuffer::Get().UploadBuffer(GL_COPY_WRITE_BUFFER, m_EBO, firstIndex * sizeof(Index), indices, indicesCount * sizeof(Index));
+
+		return mesh;
+	}
+
+	template<typename Layout>
+	void BasicMeshBatchComponent<Layout>::EditMesh(uint32_t mesh, size_t startIndex, const Vertex* newVertices, size_t newVertexCount)
+	{
+		if (mesh >= m_Data->GetMeshes().size() || !m_Data->GetMeshes()[mesh].used || startIndex + newVertexCount > m_Data->GetMeshes()[mesh].verticesCount)
+		{
+			VLK_CORE_ERROR("Mesh batch edit of {} vertices at {} is outside mesh {}.", newVertexCount, startIndex, mesh);
+
+			return;
+		}
+
+		size_t firstVertex = m_Data->GetMeshes()[mesh].firstVertex + startIndex;
+
+		CommandBuffer::Get().UploadBuffer(GL_COPY_WRITE_BUFFER, m_VBO, firstVertex * sizeof(Vertex), newVertices, newVertexCount * sizeof(Vertex));
+	}
+
+	template<typename Layout>
+	void BasicMeshBatchComponent<Layout>::RemoveMesh(uint32_t mesh)
+	{
+		if (mesh >= m_Data->GetMeshes().size() || !m_Data->GetMeshes()[mesh].used)
+		{
+			return;
+		}
+
+		typename Data::Mesh& removed = m_Data->GetMeshes()[mesh];
+
+		// Draws already recorded keep reading the old ranges, new meshes only overwrite them in later commands.
+		FreeRange(m_Data->GetFreeVertices(), removed.firstVertex, removed.verticesCount);
+		FreeRange(m_Data->GetFreeIndices(), removed.firstIndex, removed.indicesCount);
+
+		removed.used = false;
+
+		// Queued draws only hold the slot, which the next AddMesh may hand to a different mesh before they are flushed.
+		std::erase_if(m_Data->GetQueuedDraws(), [mesh](const typename Data::QueuedDraw& draw) { return draw.mesh == mesh; });
+
+		m_Data->GetFreeMeshes().push_back(mesh);
+	}
+
+	template<typename Layout>
+	void BasicMeshBatchComponent<Layout>::Draw(uint32_t mesh, ShaderComponent* shaderComponent, Texture2DComponent* textureComponent, const float* transform, uint32_t material)
+	{
+		if (mesh >= m_Data->GetMeshes().size() || !m_Data->GetMeshes()[mesh].used)
+		{
+			return;
+		}
+
+		typename Data::QueuedDraw draw;
+		draw.key = (static_cast<uint64_t>(shaderComponent->GetID()) << 32) | (textureComponent ? textureComponent->GetID() : 0);
+		draw.mesh = mesh;
+		draw.shaderComponent = shaderComponent;
+
+		if (transform)
+		{
+			std::memcpy(draw.data.transform, transform, sizeof(draw.data.transform));
+		}
+		else
+		{
+			std::memcpy(draw.data.transform, glm::value_ptr(glm::mat4(1.0f)), sizeof(draw.data.transform));
+		}
+
+		draw.data.material[0] = material;
+		draw.data.material[1] = draw.data.material[2] = draw.data.material[3] = 0;
+
+		m_Data->GetQueuedDraws().push_back(draw);
+	}
+
+	template<typename Layout>
+	void BasicMeshBatchComponent<Layout>::SetCulling(Camera3DComponent* cameraComponent, bool occlusion)
+	{
+		m_CameraComponent = cameraComponent;
+		m_Occlusion = occlusion;
+
+		if (cameraComponent && !m_Data->GetCuller())
+		{
+			m_Data->GetCuller() = Culling::CreateCuller(m_DrawCapacity, m_IndirectBuffer, m_DrawBuffer);
+		}
+	}
+
+	template<typename Layout>
+	size_t BasicMeshBatchComponent<Layout>::GetMeshCount()
+	{
+		return m_Data->GetMeshes().size() - m_Data->GetFreeMeshes().size();
+	}
+
+	template<typename Layout>
+	size_t BasicMeshBatchComponent<Layout>::GetDrawCallCount()
+	{
+		return m_DrawCallCount;
+	}
+
+	template<typename Layout>
+	const char* BasicMeshBatchComponent<Layout>::GetUUID()
+	{
+		return m_Data->GetUUID().c_str();
+	}
+
+	template<typename Layout>
+	void BasicMeshBatchComponent<Layout>::OnUpdate()
+	{
+		std::vector<typename Data::QueuedDraw>& draws = m_Data->GetQueuedDraws();
+		std::vector<uint32_t>& order = m_Data->GetOrder();
+
+		std::vector<typename Data::IndirectCommand>& commands = m_Data->GetCommands();
+		std::vector<DrawData>& drawData = m_Data->GetDrawData();
+
+		m_DrawCallCount = 0;
+
+		if (draws.empty())
+		{
+			return;
+		}
+
+		order.resize(draws.size());
+
+		for (uint32_t i = 0; i < order.size(); i++)
+		{
+			order[i] = i;
+		}
+
+		std::sort(order.begin(), order.end(), [&draws](uint32_t a, uint32_t b) { return draws[a].key < draws[b].key; });
+
+		commands.clear();
+		drawData.clear();
+
+		std::vector<Culling::Candidate>& candidates = m_Data->GetCandidates();
+		candidates.clear();
+
+		// Until its programs are linked the culler is skipped and everything is drawn.
+		Culling::Culler* culler = m_CameraComponent ? m_Data->GetCuller() : nullptr;
+
+		if (culler && !Culling::IsReady(culler))
+		{
+			culler = nullptr;
+		}
+
+		size_t drawEnd = 0;
+
+		struct Group
+		{
+			size_t first, count;
+			uint32_t programID, textureID;
+		};
+
+		std::vector<Group> groups;
+
+		size_t dropped = 0;
+
+		for (size_t start = 0; start < order.size();)
+		{
+			const typename Data::QueuedDraw& first = draws[order[start]];
+
+			size_t end = start + 1;
+
+			while (end < order.size() && draws[order[end]].key == first.key)
+			{
+				end++;
+			}
+
+			// Drawing with a program that is still linking would stall until the driver finishes it.
+			if (!first.shaderComponent->IsLoaded())
+			{
+				start = end;
+
+				continue;
+			}
+
+			// Padding keeps each group's first draw at an offset glBindBufferRange accepts, gl_DrawID restarts at 0 per group.
+			size_t groupFirst = (drawEnd + m_DrawAlignment - 1) / m_DrawAlignment * m_DrawAlignment;
+
+			size_t count = std::min(end - start, m_DrawCapacity > groupFirst ? m_DrawCapacity - groupFirst : 0);
+
+			dropped += (end - start) - count;
+
+			if (count > 0 && culler)
+			{
+				// The compute pass fills the group's range with the draws that survive.
+				for (size_t i = start; i < start + count; i++)
+				{
+					const typename Data::QueuedDraw& draw = draws[order[i]];
+					const typename Data::Mesh& mesh = m_Data->GetMeshes()[draw.mesh];
+
+					Culling::Candidate candidate;
+
+					std::memcpy(candidate.transform, draw.data.transform, sizeof(candidate.transform));
+					std::memcpy(candidate.material, draw.data.material, sizeof(candidate.material));
+					std::memcpy(candidate.sphere, mesh.sphere, sizeof(candidate.sphere));
+
+					candidate.count = static_cast<uint32_t>(mesh.indicesCount * 3);
+					candidate.firstIndex = static_cast<uint32_t>(mesh.firstIndex * 3);
+					candidate.baseVertex = static_cast<int32_t>(mesh.firstVertex);
+					candidate.group = static_cast<uint32_t>(groups.size());
+					candidate.groupFirst = static_cast<uint32_t>(groupFirst);
+					candidate.padding[0] = candidate.padding[1] = candidate.padding[2] = 0;
+
+					candidates.push_back(candidate);
+				}
+
+				groups.push_back({ groupFirst, count, static_cast<uint32_t>(first.key >> 32), static_cast<uint32_t>(first.key & 0xFFFFFFFF) });
+
+				drawEnd = groupFirst + count;
+			}
+			else if (count > 0)
+			{
+				commands.resize(groupFirst, { 0, 0, 0, 0, 0 });
+				drawData.resize(groupFirst);
+
+				for (size_t i = start; i < start + count; i++)
+				{
+					const typename Data::QueuedDraw& draw = draws[order[i]];
+					const typename Data::Mesh& mesh = m_Data->GetMeshes()[draw.mesh];
+
+					commands.push_back({ static_cast<uint32_t>(mesh.indicesCount * 3), 1, static_cast<uint32_t>(mesh.firstIndex * 3), static_cast<int32_t>(mesh.firstVertex), 0 });
+					drawData.push_back(draw.data);
+				}
+
+				groups.push_back({ groupFirst, count, static_cast<uint32_t>(first.key >> 32), static_cast<uint32_t>(first.key & 0xFFFFFFFF) });
+
+				drawEnd = groupFirst + count;
+			}
+
+			start = end;
+		}
+
+		if (dropped > 0)
+		{
+			VLK_CORE_WARN("Mesh batch holds {} draws, {} didn't fit and were skipped.", m_DrawCapacity, dropped);
+		}
+
+		draws.clear();
+
+		if (groups.empty())
+		{
+			return;
+		}
+
+		if (culler)
+		{
+			glm::mat4 viewProjection = glm::make_mat4(m_CameraComponent->GetProjectionMatrix()) * glm::make_mat4(m_CameraComponent->GetViewMatrix());
+
+			Culling::Cull(culler, candidates.data(), candidates.size(), groups.size(), glm::value_ptr(viewProjection), m_Occlusion);
+
+			for (size_t i = 0; i < groups.size(); i++)
+			{
+				const Group& group = groups[i];
+
+				CommandBuffer::Get().MultiDrawElementsIndirectCount(m_VAO, group.programID, group.textureID, m_IndirectBuffer, group.first * sizeof(typename Data::IndirectCommand), group.count, Culling::GetCountBuffer(culler), Culling::GetCountOffset(i), m_DrawBuffer, group.first * sizeof(DrawData), group.count * sizeof(DrawData));
+			}
+
+			if (m_Occlusion)
+			{
+				Culling::BuildDepthPyramid(culler);
+			}
+		}
+		else
+		{
+			CommandBuffer::Get().UploadBuffer(GL_DRAW_INDIRECT_BUFFER, m_IndirectBuffer, 0, commands.data(), commands.size() * sizeof(typename Data::IndirectCommand));
+			CommandBuffer::Get().UploadBuffer(GL_SHADER_STORAGE_BUFFER, m_DrawBuffer, 0, drawData.data(), drawData.size() * sizeof(DrawData));
+
+			for (const Group& group : groups)
+			{
+				CommandBuffer::Get().MultiDrawElementsIndirect(m_VAO, group.programID, group.textureID, m_IndirectBuffer, group.first * sizeof(typename Data::IndirectCommand), group.count, m_DrawBuffer, group.first * sizeof(DrawData), group.count * sizeof(DrawData));
+			}
+		}
+
+		m_DrawCallCount = groups.size();
+	}
+
+	template<typename Layout>
+	void BasicMeshBatchComponent<Layout>::OnEvent(Event* event, WindowComponent* windowComponent)
+	{
+	}
+
+	template<typename Layout>
+	void BasicMeshBatchComponent<Layout>::OnExit()
+	{
+		if (m_Data->GetCuller())
+		{
+			Culling::DestroyCuller(m_Data->GetCuller());
+		}
+
+		glDeleteBuffers(1, &m_VBO);
+		glDeleteBuffers(1, &m_EBO);
+		glDeleteBuffers(1, &m_IndirectBuffer);
+		glDeleteBuffers(1, &m_DrawBuffer);
+		glDeleteVertexArrays(1, &m_VAO);
+
+		delete m_Data;
+	}
+
+	template class BasicMeshBatchComponent<DefaultVertex>;
+	template class BasicMeshBatchComponent<PackedVertex>;
+
+	template<typename Layout>
+	class BasicMeshComponent<Layout>::Data
+	{
+	public:
+		Data() = default;
+		~Data() = default;
+
+		struct LOD
+		{
+			size_t firstIndex, indexCount;
+
+			float screenSize; // Used while the projected height is below this.
+		};
+
+		std::string& GetUUID()
+		{
+			return m_UUID;
+		}
+
+		std::vector<LOD>& GetLODs()
+		{
+			return m_LODs;
+		}
+
+		glm::mat4 transform = glm::mat4(1.0f);
+
+		glm::vec3 centre = glm::vec3(0.0f);
+		float radius = 0.0f;
+
+	private:
+		std::string m_UUID;
+
+		std::vector<LOD> m_LODs;
+	};
+
+	template<typename Layout>
+	BasicMeshComponent<Layout>::BasicMeshComponent(ShaderComponent* shaderComponent, Texture2DComponent* textureComponent, Camera3DComponent* cameraComponent)
+		: m_ShaderComponent(shaderComponent), m_TextureComponent(textureComponent), m_CameraComponent(cameraComponent)
+	{
+		m_Data = new Data();
+
+		UUID uuid;
+
+		uuid.GenerateUUID();
+
+		m_Data->GetUUID() = uuid.GetUUIDString();
+	}
+
+	template<typename Layout>
+	bool BasicMeshComponent<Layout>::SetData(const Vertex* vertices, size_t verticesCount, const Index* indices, size_t indicesCount, const MeshOptions& options)
+	{
+		if (FramePipeline::IsRunning())
+		{
+			VLK_CORE_ERROR("Mesh data set while the frame pipeline owns the GL context, set it before the pipeline starts.");
+
+			return false;
+		}
+
+		std::vector<float> positions(verticesCount * 3);
+
+		for (size_t i = 0; i < verticesCount; i++)
+		{
+			vertices[i].GetPosition(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+		}
+
+		size_t indexCount = indicesCount * 3;
+
+		MeshOptimizer::ProcessedMesh mesh;
+		MeshOptimizer::ProcessMesh(mesh, vertices, verticesCount, sizeof(Vertex), positions.data(), reinterpret_cast<const uint32_t*>(indices), &indexCount, 1, options);
+
+		m_Data->GetLODs().clear();
+
+		for (size_t lod = 0; lod < mesh.lods.size(); lod++)
+		{
+			m_Data->GetLODs().push_back({ mesh.lods[lod].firstIndex, mesh.lods[lod].indexCount, mesh.lodScreenSizes[lod] });
+		}
+
+		m_Data->centre = glm::vec3(mesh.centre[0], mesh.centre[1], mesh.centre[2]);
+		m_Data->radius = mesh.radius;
+
+		if (MeshOptimizer::FitsShortIndices(mesh.vertexCount))
+		{
+			std::vector<uint16_t> shortIndices(mesh.indices.size());
+
+			MeshOptimizer::ConvertToShortIndices(shortIndices.data(), mesh.indices.data(), mesh.indices.size());
+
+			m_CreateBuffers(mesh.vertices.data(), mesh.vertexCount, shortIndices.data(), shortIndices.size(), sizeof(uint16_t));
+		}
+		else
+		{
+			m_CreateBuffers(mesh.vertices.data(), mesh.vertexCount, mesh.indices.data(), mesh.indices.size(), sizeof(uint32_t));
+		}
+
+		VLK_CORE_DEBUG("Mesh: {} vertices welded to {}, {} LODs, {} bit indices, {:.2f} vertex shader runs per triangle.", verticesCount, m_VertexCount, m_Data->GetLODs().size(), m_IndexSize * 8, MeshOptimizer::GetCacheMissRatio(mesh.indices.data(), mesh.lods.front().indexCount, m_VertexCount));
+
+		return true;
+	}
+
+	template<typename Layout>
+	bool BasicMeshComponent<Layout>::Load(const char* path)
+	{
+		if (FramePipeline::IsRunning())
+		{
+			VLK_CORE_ERROR("Mesh \"{}\" loaded while the frame pipeline owns the GL context, load it before the pipeline starts.", path);
+
+			return false;
+		}
+
+		IO::FileView file = IO::MapFile(path);
+
+		if (!file.IsOpen())
+		{
+			return false;
+		}
+
+		std::span<const uint8_t> blob = file.GetData();
+
+		Cooked::MeshHeader header;
+
+		if (blob.size() < sizeof(header))
+		{
+			VLK_CORE_ERROR("Mesh: \"{}\" is truncated.", path);
+
+			return false;
+		}
+
+		std::memcpy(&header, blob.data(), sizeof(header));
+
+		if (header.magic != Cooked::MeshMagic)
+		{
+			VLK_CORE_ERROR("Mesh: \"{}\" is not a cooked mesh.", path);
+
+			return false;
+		}
+
+		if (header.version != Cooked::Version)
+		{
+			VLK_CORE_ERROR("Mesh: \"{}\" has version {}, expected {}. Cook it again with VelkroCook.", path, header.version, Cooked::Version);
+
+			return false;
+		}
+
+		bool layoutMatches = header.vertexSize == sizeof(Vertex) && header.attributeCount == Vertex::Attributes::count;
+
+		for (uint32_t i = 0; layoutMatches && i < header.attributeCount; i++)
+		{
+			const AttributeDescription& attribute = Vertex::Attributes::descriptions[i];
+			const Cooked::MeshAttribute& cooked = header.attributes[i];
+
+			layoutMatches = cooked.type == attribute.type && cooked.count == static_cast<uint32_t>(attribute.count) && (cooked.normalized != 0) == attribute.normalized && cooked.offset == attribute.offset;
+		}
+
+		if (!layoutMatches)
+		{
+			VLK_CORE_ERROR("Mesh: \"{}\" was cooked for a different vertex layout.", path);
+
+			return false;
+		}
+
+		// Counts and offsets come from the file, so every check is written so it can't overflow.
+		size_t rangeCount = static_cast<size_t>(header.lodCount) * (static_cast<size_t>(header.submeshCount) + 1);
+
+		if (header.lodCount == 0 || (header.indexSize != sizeof(uint16_t) && header.indexSize != sizeof(uint32_t)) || rangeCount > (blob.size() - sizeof(header)) / sizeof(Cooked::MeshRange) ||
+			header.vertexOffset > blob.size() || header.vertexCount > (blob.size() - header.vertexOffset) / header.vertexSize ||
+			header.indexOffset > blob.size() || header.indexCount > (blob.size() - header.indexOffset) / header.indexSize)
+		{
+			VLK_CORE_ERROR("Mesh: \"{}\" is truncated or corrupt.", path);
+
+			return false;
+		}
+
+		std::vector<typename Data::LOD> lods;
+
+		// LOD ranges come first, then the submesh ranges of every LOD, which have to lie inside it.
+		for (size_t i = 0; i < rangeCount; i++)
+		{
+			Cooked::MeshRange range;
+			std::memcpy(&range, blob.data() + sizeof(header) + i * sizeof(range), sizeof(range));
+
+			uint64_t first = range.firstIndex;
+			uint64_t end = first + range.indexCount;
+
+			bool inBounds = end <= header.indexCount;
+
+			if (i >= header.lodCount)
+			{
+				const typename Data::LOD& lod = lods[(i - header.lodCount) / header.submeshCount];
+
+				inBounds = first >= lod.firstIndex && end <= lod.firstIndex + lod.indexCount;
+			}
+
+			if (!inBounds)
+			{
+				VLK_CORE_ERROR("Mesh: \"{}\" has an index range out of bounds.", path);
+
+				return false;
+			}
+
+			if (i < header.lodCount)
+			{
+				lods.push_back({ range.firstIndex, range.indexCount, range.screenSize });
+			}
+		}
+
+		m_Data->GetLODs() = std::move(lods);
+		m_Data->centre = glm::vec3(header.centre[0], header.centre[1], header.centre[2]);
+		m_Data->radius = header.radius;
+
+		// Straight from the mapped pages into the buffers, nothing is parsed or copied on the way.
+		m_CreateBuffers(blob.data() + header.vertexOffset, header.vertexCount, blob.data() + header.indexOffset, header.indexCount, header.indexSize);
+
+		VLK_CORE_DEBUG("Mesh: Loaded \"{}\", {} vertices, {} LODs, {} bit indices.", path, m_VertexCount, m_Data->GetLODs().size(), m_IndexSize * 8);
+
+		return true;
+	}
+
+	template<typename Layout>
+	void BasicMeshComponent<Layout>::m_CreateBuffers(const void* vertices, size_t vertexCount, const void* indices, size_t indexCount, size_t indexSize)
+	{
+		m_DeleteBuffers();
+
+		m_VertexCount = vertexCount;
+		m_IndexSize = indexSize;
+
+		glCreateBuffers(1, &m_VBO);
+		glNamedBufferStorage(m_VBO, std::max<size_t>(vertexCount * sizeof(Vertex), 1), vertexCount ? vertices : nullptr, 0);
+
+		glCreateBuffers(1, &m_EBO);
+		glNamedBufferStorage(m_EBO, std::max<size_t>(indexCount * indexSize, 1), indexCount ? indices : nullptr, 0);
+
+		glCreateVertexArrays(1, &m_VAO);
+		glVertexArrayVertexBuffer(m_VAO, 0, m_VBO, 0, sizeof(Vertex));
+		glVertexArrayElementBuffer(m_VAO, m_EBO);
+
+		for (uint32_t i = 0; i < Vertex::Attributes::count; i++)
+		{
+			const AttributeDescription& attribute = Vertex::Attributes::descriptions[i];
+
+			glVertexArrayAttribFormat(m_VAO, i, attribute.count, attribute.type, attribute.normalized ? GL_TRUE : GL_FALSE, static_cast<uint32_t>(attribute.offset));
+			glVertexArrayAttribBinding(m_VAO, i, 0);
+			glEnableVertexArrayAttrib(m_VAO, i);
+		}
+	}
+
+	template<typename Layout>
+	void BasicMeshComponent<Layout>::SetTransform(const float* transform)
+	{
+		m_Data->transform = glm::make_mat4(transform);
+	}
+
+	template<typename Layout>
+	int BasicMeshComponent<Layout>::GetLODCount()
+	{
+		return static_cast<int>(m_Data->GetLODs().size());
+	}
+
+	template<typename Layout>
+	int BasicMeshComponent<Layout>::GetCurrentLOD()
+	{
+		return m_CurrentLOD;
+	}
+
+	template<typename Layout>
+	size_t BasicMeshComponent<Layout>::GetVertexCount()
+	{
+		return m_VertexCount;
+	}
+
+	template<typename Layout>
+	size_t BasicMeshComponent<Layout>::GetTriangleCount(int lod)
+	{
+		return lod >= 0 && lod < GetLODCount() ? m_Data->GetLODs()[lod].indexCount / 3 : 0;
+	}
+
+	template<typename Layout>
+	size_t BasicMeshComponent<Layout>::GetIndexSize()
+	{
+		return m_IndexSize;
+	}
+
+	template<typename Layout>
+	const char* BasicMeshComponent<Layout>::GetUUID()
+	{
+		return m_Data->GetUUID().c_str();
+	}
+
+	template<typename Layout>
+	void BasicMeshComponent<Layout>::OnUpdate()
+	{
+		if (m_Data->GetLODs().empty() || !m_ShaderComponent->IsLoaded())
+		{
+			return;
+		}
+
+		m_CurrentLOD = 0;
+
+		if (m_CameraComponent)
+		{
+			const glm::mat4& transform = m_Data->transform;
+
+			glm::vec3 centre = glm::vec3(transform * glm::vec4(m_Data->centre, 1.0f));
+
+			float scale = std::sqrt(std::max(glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0])), std::max(glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1])), glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2])))));
+
+			vec3 cameraPosition = m_CameraComponent->GetPosition();
+
+			float distance = glm::length(centre - glm::vec3(cameraPosition.x, cameraPosition.y, cameraPosition.z));
+
+			// Projected height of the bounds as a fraction of the screen, element [1][1] of the projection is 1 / tan(fov / 2).
+			float radius = m_Data->radius * scale;
+			float screenSize = distance > radius ? radius * m_CameraComponent->GetProjectionMatrix()[5] / distance : FLT_MAX;
+
+			const std::vector<typename Data::LOD>& lods = m_Data->GetLODs();
+
+			while (m_CurrentLOD + 1 < static_cast<int>(lods.size()) && screenSize < lods[m_CurrentLOD + 1].screenSize)
+			{
+				m_CurrentLOD++;
+			}
+		}
+
+		const typename Data::LOD& lod = m_Data->GetLODs()[m_CurrentLOD];
+
+		uint32_t programID = m_ShaderComponent->GetID();
+
+		CommandBuffer::Get().SetUniformMat4(programID, "u_Model", glm::value_ptr(m_Data->transform));
+		CommandBuffer::Get().DrawElements(m_VAO, programID, m_TextureComponent ? m_TextureComponent->GetID() : 0, lod.indexCount, lod.firstIndex * m_IndexSize, m_IndexSize == sizeof(uint16_t));
+	}
+
+	template<typename Layout>
+	void BasicMeshComponent<Layout>::OnEvent(Event* event, WindowComponent* windowComponent)
+	{
+	}
+
+	template<typename Layout>
+	void BasicMeshComponent<Layout>::m_DeleteBuffers()
+	{
+		if (m_VAO)
+		{
+			glDeleteBuffers(1, &m_VBO);
+			glDeleteBuffers(1, &m_EBO);
+			glDeleteVertexArrays(1, &m_VAO);
+
+			m_VAO = m_VBO = m_EBO = 0;
+		}
+	}
+
+	template<typename Layout>
+	void BasicMeshComponent<Layout>::OnExit()
+	{
+		m_DeleteBuffers();
+
+		delete m_Data;
+	}
+
+	template class BasicMeshComponent<DefaultVertex>;
+	template class BasicMeshComponent<PackedVertex>;
+
+	class SpriteComponent::Data
+	{
+	public:
+		Data() = default;
+		~Data() = default;
+
+		std::string& GetUUID()
+		{
+			return m_UUID;
+		}
+
+	private:
+		std::string m_UUID;
+	};
+
+	SpriteComponent::SpriteComponent(WindowComponent* windowComponent, ShaderComponent* shaderComponent, Texture2DComponent* textureComponent, vec3 colour, float width, float height, float x, float y, float z)
+		: m_Width(width), m_Height(height), m_X(x), m_Y(y), m_Z(z), m_PreviousX(x), m_PreviousY(y), m_PreviousZ(z)
+	{
+		m_Data = new Data();
+
+		UUID uuid;
+
+		uuid.GenerateUUID();
+
+		m_Data->GetUUID() = uuid.GetUUIDString();
+
+		m_RenderComponent = new RenderComponent(windowComponent, shaderComponent, textureComponent);
+
+		std::vector<RenderComponent::Vertex> vertices =
+		{
+			{ RenderComponent::Vertex( 1.0f,  1.0f, 0.0f, colour.x, colour.y, colour.z, 1.0f, 1.0f) }, // top right
+			{ RenderComponent::Vertex( 1.0f, -1.0f, 0.0f, colour.x, colour.y, colour.z, 1.0f, 0.0f) }, // bottom right
+			{ RenderComponent::Vertex(-1.0f, -1.0f, 0.0f, colour.x, colour.y, colour.z, 0.0f, 0.0f) }, // bottom left
+			{ RenderComponent::Vertex(-1.0f,  1.0f, 0.0f, colour.x, colour.y, colour.z, 0.0f, 1.0f) }  // top left
+		};
+
+		std::vector<RenderComponent::Index> indices =
+		{
+			{ RenderComponent::Index(0, 1, 3) },
+			{ RenderComponent::Index(1, 2, 3) }
+		};
+
+		m_RenderComponent->AddData(vertices.data(), vertices.size(), indices.data(), indices.size());
+	}
+
+	SpriteComponent::SpriteComponent(WindowComponent* windowComponent, ShaderComponent* shaderComponent, TextureAtlasComponent* textureAtlasComponent, int textureID, vec3 colour, float width, float height, float x, float y, float z)
+		: m_TextureAtlasComponent(textureAtlasComponent), m_Width(width), m_Height(height), m_X(x), m_Y(y), m_Z(z), m_Colour(colour), m_PreviousX(x), m_PreviousY(y), m_PreviousZ(z)
+	{
+		m_Data = new Data();
+
+		UUID uuid;
+
+		uuid.GenerateUUID();		
+
+		m_Data->GetUUID() = uuid.GetUUIDString();
+
+		m_RenderComponent = new RenderComponent(windowComponent, shaderComponent, textureAtlasComponent->GetTexture());
+
+		m_UV = new float[8];
+
+		m_TextureAtlasComponent->GetUV(textureID, m_UV);
+
+		m_TextureID = textureID;
+
+		std::vector<RenderComponent::Vertex> vertices =
+		{
+			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[0], m_UV[1]) }, // top right
+			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[2], m_UV[3]) }, // bottom right
+			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[4], m_UV[5]) }, // bottom left
+			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[6], m_UV[7]) }  // top left
+		};
+
+		std::vector<RenderComponent::Index> indices =
+		{
+			{ RenderComponent::Index(0, 1, 3) },
+			{ RenderComponent::Index(1, 2, 3) }
+		};
+
+		m_VerticesIndex = m_RenderComponent->AddData(vertices.data(), vertices.size(), indices.data(), indices.size());
+	}
+
+	void SpriteComponent::TransformSprite(float width, float height, float x, float y, float z, vec3 colour, int textureID)
+	{
+		m_Width = width;
+		m_Height = height;
+		m_X = x;
+		m_Y = y;
+		m_Z = z;
+		m_Colour = colour;
+
+		m_TextureAtlasComponent->GetUV(textureID, m_UV);
+
+		m_TextureID = textureID;
+
+		m_WriteVertices(m_X, m_Y, m_Z);
+	}
+	void SpriteComponent::TransformSprite(float width, float height, float x, float y, float z, vec3 colour)
+	{
 		m_Width = width;
 		m_Height = height;
 		m_X = x;
@@ -655,131 +1829,1085 @@ namespace Velkro
 		m_Z = z;
 		m_Colour = colour;
 
-		m_TextureAtlasComponent->GetUV(textureID, m_UV);
+		m_WriteVertices(m_X, m_Y, m_Z);
+	}
+	void SpriteComponent::TransformSprite(float width, float height, float x, float y, float z)
+	{
+		m_Width = width;
+		m_Height = height;
+		m_X = x;
+		m_Y = y;
+
+		m_WriteVertices(m_X, m_Y, m_Z);
+	}
+	void SpriteComponent::SetSpriteSize(float width, float height)
+	{
+		m_Width = width;
+		m_Height = height;
+
+		m_WriteVertices(m_X, m_Y, m_Z);
+	}
+	void SpriteComponent::SetSpritePos(float x, float y, float z)
+	{
+		m_X = x;
+		m_Y = y;
+		m_Z = z;
+
+		m_WriteVertices(m_X, m_Y, m_Z);
+	}
+	void SpriteComponent::SetSpriteColour(vec3 colour)
+	{
+		m_Colour = colour;
+
+		m_WriteVertices(m_X, m_Y, m_Z);
+	}
+	void SpriteComponent::SetSpriteTextureID(int textureID)
+	{
+		// Placeholder UVs of a streaming atlas still need replacing once it has loaded.
+		if (textureID == m_TextureID && m_TextureAtlasComponent->GetTexture()->IsLoaded())
+		{
+			return;
+		}
+
+		m_TextureAtlasComponent->GetUV(textureID, m_UV);
+
+		m_TextureID = textureID;
+
+		// Positions are left alone, they may be interpolated.
+		m_RenderComponent->EditVertexUVs(m_VerticesIndex, m_UV, 4);
+	}
+
+	void SpriteComponent::m_WriteVertices(float x, float y, float z)
+	{
+		RenderComponent::Vertex vertices[4] =
+		{
+			{ RenderComponent::Vertex(x + ( m_Width / 2), y + ( m_Height / 2), z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[0], m_UV[1]) }, // top right
+			{ RenderComponent::Vertex(x + ( m_Width / 2), y + (-m_Height / 2), z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[2], m_UV[3]) }, // bottom right
+			{ RenderComponent::Vertex(x + (-m_Width / 2), y + (-m_Height / 2), z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[4], m_UV[5]) }, // bottom left
+			{ RenderComponent::Vertex(x + (-m_Width / 2), y + ( m_Height / 2), z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[6], m_UV[7]) }  // top left
+		};
+
+		m_RenderComponent->EditVertexData(m_VerticesIndex, vertices, 4);
+	}
+
+	void SpriteComponent::OnUpdate()
+	{
+		if (Engine::IsFixedTimestep() && m_UV && (m_PreviousX != m_X || m_PreviousY != m_Y || m_PreviousZ != m_Z))
+		{
+			float alpha = Engine::GetInterpolationAlpha();
+
+			m_WriteVertices(m_PreviousX + (m_X - m_PreviousX) * alpha, m_PreviousY + (m_Y - m_PreviousY) * alpha, m_PreviousZ + (m_Z - m_PreviousZ) * alpha);
+
+			m_Interpolated = true;
+		}
+		else if (m_Interpolated)
+		{
+			m_WriteVertices(m_X, m_Y, m_Z);
+
+			m_Interpolated = false;
+		}
+
+		m_RenderComponent->OnUpdate();
+	}
+	void SpriteComponent::OnFixedUpdate()
+	{
+		m_PreviousX = m_X;
+		m_PreviousY = m_Y;
+		m_PreviousZ = m_Z;
+	}
+	void SpriteComponent::OnEvent(Event* event, WindowComponent* windowComponent)
+	{
+		m_RenderComponent->OnEvent(event, windowComponent);
+	}
+	void SpriteComponent::OnExit()
+	{
+		m_RenderComponent->OnExit();
+
+		delete m_Data;
+	}
+
+	const char* SpriteComponent::GetUUID()
+	{
+		return m_Data->GetUUID().c_str();
+	}	
+
+	class SpriteAnimationComponent::Data
+	{
+	public:
+		Data() = default;
+		~Data() = default;
+
+		struct Clip
+		{
+			size_t firstFrame, frameCount;
+			bool loop;
+		};
+
+		std::string& GetUUID()
+		{
+			return m_UUID;
+		}
+
+		// Frames of every clip back to back.
+		std::vector<int>& GetFrameTextures()
+		{
+			return m_FrameTextures;
+		}
+		std::vector<float>& GetFrameDurations()
+		{
+			return m_FrameDurations;
+		}
+		std::vector<Clip>& GetClips()
+		{
+			return m_Clips;
+		}
+
+		// Playback state, one entry per sprite.
+		std::vector<SpriteComponent*>& GetSprites()
+		{
+			return m_Sprites;
+		}
+		std::vector<int>& GetSpriteClips()
+		{
+			return m_SpriteClips;
+		}
+		std::vector<int>& GetSpriteFrames()
+		{
+			return m_SpriteFrames;
+		}
+		std::vector<float>& GetSpriteTimes()
+		{
+			return m_SpriteTimes;
+		}
+		std::vector<float>& GetSpriteSpeeds()
+		{
+			return m_SpriteSpeeds;
+		}
+		std::vector<uint8_t>& GetSpriteFinished()
+		{
+			return m_SpriteFinished;
+		}
+
+	private:
+		std::string m_UUID;
+
+		std::vector<int> m_FrameTextures;
+		std::vector<float> m_FrameDurations;
+		std::vector<Clip> m_Clips;
+
+		std::vector<SpriteComponent*> m_Sprites;
+		std::vector<int> m_SpriteClips;
+		std::vector<int> m_SpriteFrames;
+		std::vector<float> m_SpriteTimes;
+		std::vector<float> m_SpriteSpeeds;
+		std::vector<uint8_t> m_SpriteFinished;
+	};
+
+	SpriteAnimationComponent::SpriteAnimationComponent()
+	{
+		m_Data = new Data();
+
+		UUID uuid;
+
+		uuid.GenerateUUID();
+
+		m_Data->GetUUID() = uuid.GetUUIDString();
+	}
+
+	int SpriteAnimationComponent::AddClip(const AnimationClip& clip)
+	{
+		if (clip.frames.empty() || clip.durations.empty() || (clip.durations.size() != 1 && clip.durations.size() != clip.frames.size()))
+		{
+			VLK_CORE_ERROR("Animation clip needs at least one frame and either one duration or one per frame.");
+
+			return -1;
+		}
+
+		std::vector<int>& frameTextures = m_Data->GetFrameTextures();
+		std::vector<float>& frameDurations = m_Data->GetFrameDurations();
+
+		m_Data->GetClips().push_back({ frameTextures.size(), clip.frames.size(), clip.loop });
+
+		for (size_t i = 0; i < clip.frames.size(); i++)
+		{
+			frameTextures.push_back(clip.frames[i]);
+			frameDurations.push_back(std::max(clip.durations[clip.durations.size() == 1 ? 0 : i], 0.0001f));
+		}
+
+		return static_cast<int>(m_Data->GetClips().size() - 1);
+	}
+
+	int SpriteAnimationComponent::AddSprite(SpriteComponent* spriteComponent, int clip, float speed)
+	{
+		m_Data->GetSprites().push_back(spriteComponent);
+		m_Data->GetSpriteClips().push_back(-1); // Set by Play once the clip is known to exist.
+		m_Data->GetSpriteFrames().push_back(0);
+		m_Data->GetSpriteTimes().push_back(0.0f);
+		m_Data->GetSpriteSpeeds().push_back(speed);
+		m_Data->GetSpriteFinished().push_back(0);
+
+		int sprite = static_cast<int>(m_Data->GetSprites().size() - 1);
+
+		Play(sprite, clip);
+
+		return sprite;
+	}
+
+	void SpriteAnimationComponent::Play(int sprite, int clip)
+	{
+		if (clip < 0 || clip >= static_cast<int>(m_Data->GetClips().size()))
+		{
+			VLK_CORE_ERROR("Animation clip {} doesn't exist.", clip);
+
+			return;
+		}
+
+		m_Data->GetSpriteClips()[sprite] = clip;
+		m_Data->GetSpriteFrames()[sprite] = 0;
+		m_Data->GetSpriteTimes()[sprite] = 0.0f;
+		m_Data->GetSpriteFinished()[sprite] = 0;
+
+		m_Data->GetSprites()[sprite]->SetSpriteTextureID(m_Data->GetFrameTextures()[m_Data->GetClips()[clip].firstFrame]);
+	}
+
+	void SpriteAnimationComponent::SetSpeed(int sprite, float speed)
+	{
+		m_Data->GetSpriteSpeeds()[sprite] = speed;
+	}
+
+	bool SpriteAnimationComponent::IsFinished(int sprite)
+	{
+		return m_Data->GetSpriteFinished()[sprite] != 0;
+	}
+
+	void SpriteAnimationComponent::Advance(float seconds)
+	{
+		const int* frameTextures = m_Data->GetFrameTextures().data();
+		const float* frameDurations = m_Data->GetFrameDurations().data();
+		const Data::Clip* clips = m_Data->GetClips().data();
+
+		SpriteComponent** sprites = m_Data->GetSprites().data();
+		const int* spriteClips = m_Data->GetSpriteClips().data();
+		int* spriteFrames = m_Data->GetSpriteFrames().data();
+		float* spriteTimes = m_Data->GetSpriteTimes().data();
+		const float* spriteSpeeds = m_Data->GetSpriteSpeeds().data();
+		uint8_t* spriteFinished = m_Data->GetSpriteFinished().data();
+
+		size_t spriteCount = m_Data->GetSprites().size();
+
+		for (size_t i = 0; i < spriteCount; i++)
+		{
+			if (spriteSpeeds[i] == 0.0f || spriteFinished[i] || spriteClips[i] < 0)
+			{
+				continue;
+			}
+
+			const Data::Clip& clip = clips[spriteClips[i]];
+
+			int frame = spriteFrames[i];
+			float time = spriteTimes[i] + seconds * spriteSpeeds[i];
+
+			while (time >= frameDurations[clip.firstFrame + frame])
+			{
+				time -= frameDurations[clip.firstFrame + frame];
+
+				if (frame + 1 < static_cast<int>(clip.frameCount))
+				{
+					frame++;
+				}
+				else if (clip.loop)
+				{
+					frame = 0;
+				}
+				else
+				{
+					time = 0.0f;
+					spriteFinished[i] = 1;
+
+					break;
+				}
+			}
+
+			spriteTimes[i] = time;
+
+			if (frame != spriteFrames[i])
+			{
+				spriteFrames[i] = frame;
+
+				sprites[i]->SetSpriteTextureID(frameTextures[clip.firstFrame + frame]);
+			}
+		}
+	}
+
+	const char* SpriteAnimationComponent::GetUUID()
+	{
+		return m_Data->GetUUID().c_str();
+	}
+
+	void SpriteAnimationComponent::OnUpdate()
+	{
+		Advance(static_cast<float>(Engine::GetFrameTime()));
+	}
+	void SpriteAnimationComponent::OnEvent(Event* event, WindowComponent* windowComponent)
+	{
+	}
+	void SpriteAnimationComponent::OnExit()
+	{
+		delete m_Data;
+	}
+
+	class SpriteBatchComponent::Data
+	{
+	public:
+		Data() = default;
+		~Data() = default;
+
+		std::string& GetUUID()
+		{
+			return m_UUID;
+		}
+
+	private:
+		std::string m_UUID;
+	};
+
+	struct SpriteBatchResize
+	{
+		uint32_t vertexBuffer, elementBuffer;
+		size_t quadCapacity;
+	};
+
+	// Runs on the GL thread before the upload that needed the room, so the storage can be specified again without syncing.
+	static void ResizeSpriteBatch(void* userData)
+	{
+		SpriteBatchResize* resize = static_cast<SpriteBatchResize*>(userData);
+
+		std::vector<uint32_t> indices(resize->quadCapacity * 6);
+
+		for (size_t quad = 0; quad < resize->quadCapacity; quad++)
+		{
+			uint32_t first = static_cast<uint32_t>(quad * 4);
+
+			uint32_t* index = indices.data() + quad * 6;
+			index[0] = first; index[1] = first + 1; index[2] = first + 3;
+			index[3] = first + 1; index[4] = first + 2; index[5] = first + 3;
+		}
+
+		glNamedBufferData(resize->vertexBuffer, resize->quadCapacity * 4 * sizeof(RenderComponent::Vertex), nullptr, GL_DYNAMIC_DRAW);
+		glNamedBufferData(resize->elementBuffer, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+
+		delete resize;
+	}
+
+	SpriteBatchComponent::SpriteBatchComponent(WindowComponent* windowComponent, ShaderComponent* shaderComponent, TextureAtlasComponent* textureAtlasComponent)
+		: m_ShaderComponent(shaderComponent), m_TextureAtlasComponent(textureAtlasComponent)
+	{
+		m_Data = new Data();
+
+		UUID uuid;
+
+		uuid.GenerateUUID();
+
+		m_Data->GetUUID() = uuid.GetUUIDString();
+
+		glCreateBuffers(1, &m_VBO);
+		glCreateBuffers(1, &m_EBO);
+
+		glCreateVertexArrays(1, &m_VAO);
+		glVertexArrayVertexBuffer(m_VAO, 0, m_VBO, 0, sizeof(RenderComponent::Vertex));
+		glVertexArrayElementBuffer(m_VAO, m_EBO);
+
+		for (uint32_t i = 0; i < RenderComponent::Vertex::Attributes::count; i++)
+		{
+			const AttributeDescription& attribute = RenderComponent::Vertex::Attributes::descriptions[i];
+
+			glVertexArrayAttribFormat(m_VAO, i, attribute.count, attribute.type, attribute.normalized ? GL_TRUE : GL_FALSE, static_cast<uint32_t>(attribute.offset));
+			glVertexArrayAttribBinding(m_VAO, i, 0);
+			glEnableVertexArrayAttrib(m_VAO, i);
+		}
+	}
+
+	void SpriteBatchComponent::SetSprites(const SpriteArrays& sprites, size_t count)
+	{
+		m_SpriteCount = count;
+
+		if (count == 0)
+		{
+			return;
+		}
+
+		if (count > m_QuadCapacity)
+		{
+			m_QuadCapacity = std::max(count, m_QuadCapacity * 2);
+
+			CommandBuffer::Get().Call(ResizeSpriteBatch, new SpriteBatchResize{ m_VBO, m_EBO, m_QuadCapacity });
+		}
+
+		const UVRect* UVs = m_TextureAtlasComponent->GetUVs();
+		int UVCount = m_TextureAtlasComponent->GetTextureCount();
+
+		size_t verticesSize = count * 4 * sizeof(RenderComponent::Vertex);
+
+		RenderComponent::Vertex* vertices = static_cast<RenderComponent::Vertex*>(CommandBuffer::Get().UploadBuffer(GL_COPY_WRITE_BUFFER, m_VBO, 0, verticesSize));
+
+		Sprites::GenerateQuads(sprites, count, UVs, UVCount, vertices);
+	}
+
+	size_t SpriteBatchComponent::GetSpriteCount()
+	{
+		return m_SpriteCount;
+	}
+
+	const char* SpriteBatchComponent::GetUUID()
+	{
+		return m_Data->GetUUID().c_str();
+	}
+
+	void SpriteBatchComponent::OnUpdate()
+	{
+		if (m_SpriteCount == 0 || !m_ShaderComponent->IsLoaded())
+		{
+			return;
+		}
+
+		CommandBuffer::Get().DrawElements(m_VAO, m_ShaderComponent->GetID(), m_TextureAtlasComponent->GetTexture()->GetID(), m_SpriteCount * 6);
+	}
+	void SpriteBatchComponent::OnEvent(Event* event, WindowComponent* windowComponent)
+	{
+	}
+	void SpriteBatchComponent::OnExit()
+	{
+		glDeleteBuffers(1, &m_VBO);
+		glDeleteBuffers(1, &m_EBO);
+		glDeleteVertexArrays(1, &m_VAO);
+
+		delete m_Data;
+	}
+
+	class TilemapComponent::Data
+	{
+	public:
+		Data() = default;
+		~Data() = default;
+
+		struct Chunk
+		{
+			uint32_t vertexArray = 0, vertexBuffer = 0;
+
+			int column, row; // First tile of the chunk.
+			int width, height; // In tiles, smaller at the edges of the map.
+
+			uint32_t quadCount = 0;
+
+			bool dirty = true;
+		};
+
+		std::string& GetUUID()
+		{
+			return m_UUID;
+		}
+
+		std::vector<int>& GetTiles()
+		{
+			return m_Tiles;
+		}
+		std::vector<Chunk>& GetChunks()
+		{
+			return m_Chunks;
+		}
+		std::vector<DefaultVertex>& GetScratchVertices()
+		{
+			return m_ScratchVertices;
+		}
+
+		uint32_t& GetElementBuffer()
+		{
+			return m_ElementBuffer;
+		}
+
+		int width, height;
+		int chunkSize;
+		int chunksPerRow;
+
+		float tileSize;
+		glm::vec3 position;
+
+		int drawnChunkCount = 0;
+
+	private:
+		std::string m_UUID;
+
+		std::vector<int> m_Tiles;
+		std::vector<Chunk> m_Chunks;
+
+		std::vector<DefaultVertex> m_ScratchVertices; // Reused by every chunk rebuild.
+
+		uint32_t m_ElementBuffer = 0; // Quad indices for a full chunk, shared by every chunk.
+	};
+
+	TilemapComponent::TilemapComponent(ShaderComponent* shaderComponent, TextureAtlasComponent* textureAtlasComponent, Camera3DComponent* cameraComponent, int width, int height, float tileSize, vec3 position, int chunkSize)
+		: m_ShaderComponent(shaderComponent), m_TextureAtlasComponent(textureAtlasComponent), m_CameraComponent(cameraComponent)
+	{
+		m_Data = new Data();
+
+		UUID uuid;
+
+		uuid.GenerateUUID();
+
+		m_Data->GetUUID() = uuid.GetUUIDString();
+
+		if (width < 0 || height < 0 || chunkSize <= 0)
+		{
+			VLK_CORE_ERROR("Tilemap of {}x{} tiles with a chunk size of {} is invalid, it is left empty.", width, height, chunkSize);
+
+			width = height = 0;
+			chunkSize = 1;
+		}
+
+		m_Data->width = width;
+		m_Data->height = height;
+		m_Data->chunkSize = chunkSize;
+		m_Data->chunksPerRow = (width + chunkSize - 1) / chunkSize;
+		m_Data->tileSize = tileSize;
+		m_Data->position = glm::vec3(position.x, position.y, position.z);
+
+		m_Data->GetTiles().assign(static_cast<size_t>(width) * height, -1);
+
+		size_t chunkQuadCount = static_cast<size_t>(chunkSize) * chunkSize;
+
+		std::vector<uint32_t> indices(chunkQuadCount * 6);
+
+		for (size_t quad = 0; quad < chunkQuadCount; quad++)
+		{
+			uint32_t first = static_cast<uint32_t>(quad * 4);
+
+			uint32_t* index = indices.data() + quad * 6;
+			index[0] = first; index[1] = first + 1; index[2] = first + 3;
+			index[3] = first + 1; index[4] = first + 2; index[5] = first + 3;
+		}
+
+		glCreateBuffers(1, &m_Data->GetElementBuffer());
+		glNamedBufferStorage(m_Data->GetElementBuffer(), indices.size() * sizeof(uint32_t), indices.data(), 0);
+
+		int chunksPerColumn = (height + chunkSize - 1) / chunkSize;
+
+		for (int chunkRow = 0; chunkRow < chunksPerColumn; chunkRow++)
+		{
+			for (int chunkColumn = 0; chunkColumn < m_Data->chunksPerRow; chunkColumn++)
+			{
+				Data::Chunk chunk;
+				chunk.column = chunkColumn * chunkSize;
+				chunk.row = chunkRow * chunkSize;
+				chunk.width = std::min(chunkSize, width - chunk.column);
+				chunk.height = std::min(chunkSize, height - chunk.row);
+
+				// Immutable storage sized for a full chunk, rebuilds overwrite it in place.
+				glCreateBuffers(1, &chunk.vertexBuffer);
+				glNamedBufferStorage(chunk.vertexBuffer, static_cast<size_t>(chunk.width) * chunk.height * 4 * sizeof(DefaultVertex), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+				glCreateVertexArrays(1, &chunk.vertexArray);
+				glVertexArrayVertexBuffer(chunk.vertexArray, 0, chunk.vertexBuffer, 0, sizeof(DefaultVertex));
+				glVertexArrayElementBuffer(chunk.vertexArray, m_Data->GetElementBuffer());
+
+				for (uint32_t i = 0; i < DefaultVertex::Attributes::count; i++)
+				{
+					const AttributeDescription& attribute = DefaultVertex::Attributes::descriptions[i];
+
+					glVertexArrayAttribFormat(chunk.vertexArray, i, attribute.count, attribute.type, attribute.normalized ? GL_TRUE : GL_FALSE, static_cast<uint32_t>(attribute.offset));
+					glVertexArrayAttribBinding(chunk.vertexArray, i, 0);
+					glEnableVertexArrayAttrib(chunk.vertexArray, i);
+				}
+
+				m_Data->GetChunks().push_back(chunk);
+			}
+		}
+	}
+
+	void TilemapComponent::SetTile(int column, int row, int textureID)
+	{
+		if (column < 0 || row < 0 || column >= m_Data->width || row >= m_Data->height)
+		{
+			VLK_CORE_ERROR("Tile ({}, {}) is outside the {}x{} tilemap.", column, row, m_Data->width, m_Data->height);
+
+			return;
+		}
+
+		// Only checked once the atlas is loaded, a streaming atlas doesn't know its texture count yet.
+		if (textureID >= 0 && m_TextureAtlasComponent->GetTexture()->IsLoaded() && textureID >= m_TextureAtlasComponent->GetTextureCount())
+		{
+			VLK_CORE_ERROR("Texture ID {} is out of range for an atlas holding {} textures.", textureID, m_TextureAtlasComponent->GetTextureCount());
+
+			return;
+		}
+
+		int& tile = m_Data->GetTiles()[static_cast<size_t>(row) * m_Data->width + column];
 
-		std::vector<RenderComponent::Vertex> vertices =
+		if (tile == textureID)
 		{
-			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[0], m_UV[1]) }, // top right
-			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[2], m_UV[3]) }, // bottom right
-			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[4], m_UV[5]) }, // bottom left
-			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[6], m_UV[7]) }  // top left
-		};
+			return;
+		}
+
+		tile = textureID;
 
-		m_RenderComponent->EditVertexData(m_VerticesIndex, vertices.data(), vertices.size());
+		m_Data->GetChunks()[(row / m_Data->chunkSize) * m_Data->chunksPerRow + column / m_Data->chunkSize].dirty = true;
 	}
-	void SpriteComponent::TransformSprite(float width, float height, float x, float y, float z, vec3 colour)
+
+	void TilemapComponent::SetTiles(const int* textureIDs)
 	{
-		m_Width = width;
-		m_Height = height;
-		m_X = x;
-		m_Y = y;
-		m_Z = z;
-		m_Colour = colour;
+		std::copy(textureIDs, textureIDs + m_Data->GetTiles().size(), m_Data->GetTiles().begin());
 
-		std::vector<RenderComponent::Vertex> vertices =
+		if (m_TextureAtlasComponent->GetTexture()->IsLoaded())
 		{
-			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[0], m_UV[1]) }, // top right
-			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[2], m_UV[3]) }, // bottom right
-			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[4], m_UV[5]) }, // bottom left
-			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[6], m_UV[7]) }  // top left
-		};
+			int textureCount = m_TextureAtlasComponent->GetTextureCount();
+			size_t invalidCount = 0;
+
+			for (int& tile : m_Data->GetTiles())
+			{
+				if (tile >= textureCount)
+				{
+					tile = -1;
+					invalidCount++;
+				}
+			}
+
+			if (invalidCount)
+			{
+				VLK_CORE_ERROR("{} tiles have texture IDs out of range for an atlas holding {} textures, they are left empty.", invalidCount, textureCount);
+			}
+		}
 
-		m_RenderComponent->EditVertexData(m_VerticesIndex, vertices.data(), vertices.size());
+		for (Data::Chunk& chunk : m_Data->GetChunks())
+		{
+			chunk.dirty = true;
+		}
 	}
-	void SpriteComponent::TransformSprite(float width, float height, float x, float y, float z)
+
+	int TilemapComponent::GetTile(int column, int row)
 	{
-		m_Width = width;
-		m_Height = height;
-		m_X = x;
-		m_Y = y;
+		if (column < 0 || row < 0 || column >= m_Data->width || row >= m_Data->height)
+		{
+			return -1;
+		}
 
-		std::vector<RenderComponent::Vertex> vertices =
+		return m_Data->GetTiles()[static_cast<size_t>(row) * m_Data->width + column];
+	}
+
+	int TilemapComponent::GetDrawnChunkCount()
+	{
+		return m_Data->drawnChunkCount;
+	}
+
+	void TilemapComponent::m_BuildChunk(size_t chunkIndex)
+	{
+		Data::Chunk& chunk = m_Data->GetChunks()[chunkIndex];
+
+		std::vector<DefaultVertex>& vertices = m_Data->GetScratchVertices();
+		vertices.clear();
+
+		float tileSize = m_Data->tileSize;
+		glm::vec3 position = m_Data->position;
+
+		float UV[8] = {};
+
+		// Chunks are only built once the atlas is loaded, so IDs set while it was still streaming are checked here.
+		int textureCount = m_TextureAtlasComponent->GetTextureCount();
+
+		for (int row = chunk.row; row < chunk.row + chunk.height; row++)
 		{
-			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[0], m_UV[1]) }, // top right
-			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[2], m_UV[3]) }, // bottom right
-			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[4], m_UV[5]) }, // bottom left
-			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[6], m_UV[7]) }  // top left
-		};
+			for (int column = chunk.column; column < chunk.column + chunk.width; column++)
+			{
+				int textureID = m_Data->GetTiles()[static_cast<size_t>(row) * m_Data->width + column];
+
+				if (textureID < 0 || textureID >= textureCount)
+				{
+					continue;
+				}
+
+				m_TextureAtlasComponent->GetUV(textureID, UV);
+
+				float left = position.x + column * tileSize;
+				float right = left + tileSize;
+				float bottom = position.y + row * tileSize;
+				float top = bottom + tileSize;
+
+				vertices.push_back({ right, top, position.z, 1.0f, 1.0f, 1.0f, UV[0], UV[1] }); // top right
+				vertices.push_back({ right, bottom, position.z, 1.0f, 1.0f, 1.0f, UV[2], UV[3] }); // bottom right
+				vertices.push_back({ left, bottom, position.z, 1.0f, 1.0f, 1.0f, UV[4], UV[5] }); // bottom left
+				vertices.push_back({ left, top, position.z, 1.0f, 1.0f, 1.0f, UV[6], UV[7] }); // top left
+			}
+		}
+
+		chunk.quadCount = static_cast<uint32_t>(vertices.size() / 4);
+		chunk.dirty = false;
 
-		m_RenderComponent->EditVertexData(m_VerticesIndex, vertices.data(), vertices.size());
+		if (!vertices.empty())
+		{
+			CommandBuffer::Get().UploadBuffer(GL_ARRAY_BUFFER, chunk.vertexBuffer, 0, vertices.data(), vertices.size() * sizeof(DefaultVertex));
+		}
 	}
-	void SpriteComponent::SetSpriteSize(float width, float height)
+
+	const char* TilemapComponent::GetUUID()
 	{
-		m_Width = width;
-		m_Height = height;
+		return m_Data->GetUUID().c_str();
+	}
 
-		std::vector<RenderComponent::Vertex> vertices =
+	void TilemapComponent::OnUpdate()
+	{
+		m_Data->drawnChunkCount = 0;
+
+		// UVs aren't known until the atlas has streamed in.
+		if (!m_ShaderComponent->IsLoaded() || !m_TextureAtlasComponent->GetTexture()->IsLoaded())
 		{
-			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[0], m_UV[1]) }, // top right
-			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[2], m_UV[3]) }, // bottom right
-			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[4], m_UV[5]) }, // bottom left
-			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[6], m_UV[7]) }  // top left
-		};
+			return;
+		}
+
+		glm::mat4 viewProjection(1.0f);
+
+		if (m_CameraComponent)
+		{
+			viewProjection = glm::make_mat4(m_CameraComponent->GetProjectionMatrix()) * glm::make_mat4(m_CameraComponent->GetViewMatrix());
+		}
+
+		std::vector<Data::Chunk>& chunks = m_Data->GetChunks();
+
+		float tileSize = m_Data->tileSize;
+		glm::vec3 position = m_Data->position;
+
+		uint32_t programID = m_ShaderComponent->GetID();
+		uint32_t textureID = m_TextureAtlasComponent->GetTexture()->GetID();
+
+		for (size_t i = 0; i < chunks.size(); i++)
+		{
+			Data::Chunk& chunk = chunks[i];
+
+			if (chunk.dirty)
+			{
+				m_BuildChunk(i);
+			}
+
+			if (chunk.quadCount == 0)
+			{
+				continue;
+			}
+
+			if (m_CameraComponent)
+			{
+				float left = position.x + chunk.column * tileSize;
+				float right = left + chunk.width * tileSize;
+				float bottom = position.y + chunk.row * tileSize;
+				float top = bottom + chunk.height * tileSize;
+
+				glm::vec4 corners[4] =
+				{
+					viewProjection * glm::vec4(left, bottom, position.z, 1.0f),
+					viewProjection * glm::vec4(right, bottom, position.z, 1.0f),
+					viewProjection * glm::vec4(left, top, position.z, 1.0f),
+					viewProjection * glm::vec4(right, top, position.z, 1.0f)
+				};
+
+				// Culled only when every corner is outside the same clip plane.
+				bool culled = false;
+
+				for (int axis = 0; axis < 3 && !culled; axis++)
+				{
+					bool allBelow = true, allAbove = true;
+
+					for (const glm::vec4& corner : corners)
+					{
+						allBelow = allBelow && corner[axis] < -corner.w;
+						allAbove = allAbove && corner[axis] > corner.w;
+					}
+
+					culled = allBelow || allAbove;
+				}
+
+				if (culled)
+				{
+					continue;
+				}
+			}
+
+			CommandBuffer::Get().DrawElements(chunk.vertexArray, programID, textureID, static_cast<size_t>(chunk.quadCount) * 6);
+
+			m_Data->drawnChunkCount++;
+		}
+	}
+	void TilemapComponent::OnEvent(Event* event, WindowComponent* windowComponent)
+	{
+	}
+	void TilemapComponent::OnExit()
+	{
+		for (Data::Chunk& chunk : m_Data->GetChunks())
+		{
+			glDeleteVertexArrays(1, &chunk.vertexArray);
+			glDeleteBuffers(1, &chunk.vertexBuffer);
+		}
+
+		glDeleteBuffers(1, &m_Data->GetElementBuffer());
 
-		m_RenderComponent->EditVertexData(m_VerticesIndex, vertices.data(), vertices.size());
+		delete m_Data;
 	}
-	void SpriteComponent::SetSpritePos(float x, float y, float z)
+
+	class TextComponent::Data
+	{
+	public:
+		Data() = default;
+		~Data() = default;
+
+		std::string& GetUUID()
+		{
+			return m_UUID;
+		}
+
+		std::string& GetText()
+		{
+			return m_Text;
+		}
+
+		std::vector<Font::GlyphQuad>& GetQuads()
+		{
+			return m_Quads;
+		}
+
+	private:
+		std::string m_UUID;
+		std::string m_Text;
+
+		std::vector<Font::GlyphQuad> m_Quads;
+	};
+
+	TextComponent::TextComponent(WindowComponent* windowComponent, ShaderComponent* shaderComponent, const char* fontPath, const char* text, float size, vec3 colour, float x, float y, float z)
+		: m_Size(size), m_X(x), m_Y(y), m_Z(z), m_Colour(colour)
+	{
+		m_Data = new Data();
+
+		UUID uuid;
+
+		uuid.GenerateUUID();
+
+		m_Data->GetUUID() = uuid.GetUUIDString();
+		m_Data->GetText() = text;
+
+		m_Font = Assets::AcquireFont(fontPath);
+
+		m_Page = m_Font->font->IsLoaded() ? new Texture2DComponent(m_Font->font->GetPage()) : nullptr;
+
+		m_RenderComponent = m_Page ? new RenderComponent(windowComponent, shaderComponent, m_Page) : nullptr;
+	}
+
+	void TextComponent::SetText(const char* text)
+	{
+		if (m_Data->GetText() != text)
+		{
+			m_Data->GetText() = text;
+
+			m_Dirty = true;
+		}
+	}
+	void TextComponent::SetSize(float size)
+	{
+		m_Size = size;
+
+		m_Dirty = true;
+	}
+	void TextComponent::SetPosition(float x, float y, float z)
 	{
 		m_X = x;
 		m_Y = y;
 		m_Z = z;
 
-		std::vector<RenderComponent::Vertex> vertices =
+		m_Dirty = true;
+	}
+	void TextComponent::SetColour(vec3 colour)
+	{
+		m_Colour = colour;
+
+		m_Dirty = true;
+	}
+
+	float TextComponent::GetWidth()
+	{
+		return m_Font->font->IsLoaded() ? m_Font->font->MeasureText(m_Data->GetText(), m_Size) : 0.0f;
+	}
+
+	void TextComponent::m_Build()
+	{
+		std::vector<Font::GlyphQuad>& quads = m_Data->GetQuads();
+
+		m_Font->font->LayoutText(m_Data->GetText(), m_Size, quads);
+
+		RenderComponent::Vertex* vertices = m_RenderComponent->SetQuadCount(quads.size());
+
+		for (const Font::GlyphQuad& quad : quads)
 		{
-			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[0], m_UV[1]) }, // top right
-			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[2], m_UV[3]) }, // bottom right
-			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[4], m_UV[5]) }, // bottom left
-			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[6], m_UV[7]) }  // top left
-		};
+			float left = m_X + quad.left, right = m_X + quad.right;
+			float bottom = m_Y + quad.bottom, top = m_Y + quad.top;
 
-		m_RenderComponent->EditVertexData(m_VerticesIndex, vertices.data(), vertices.size());
+			*vertices++ = { right, top, m_Z, m_Colour.x, m_Colour.y, m_Colour.z, quad.uMax, quad.vMax }; // top right
+			*vertices++ = { right, bottom, m_Z, m_Colour.x, m_Colour.y, m_Colour.z, quad.uMax, quad.vMin }; // bottom right
+			*vertices++ = { left, bottom, m_Z, m_Colour.x, m_Colour.y, m_Colour.z, quad.uMin, quad.vMin }; // bottom left
+			*vertices++ = { left, top, m_Z, m_Colour.x, m_Colour.y, m_Colour.z, quad.uMin, quad.vMax }; // top left
+		}
+
+		m_QuadCount = quads.size();
+
+		m_Dirty = false;
 	}
-	void SpriteComponent::SetSpriteColour(vec3 colour)
+
+	const char* TextComponent::GetUUID()
 	{
-		m_Colour = colour;
+		return m_Data->GetUUID().c_str();
+	}
 
-		std::vector<RenderComponent::Vertex> vertices =
+	void TextComponent::OnUpdate()
+	{
+		if (!m_RenderComponent)
 		{
-			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[0], m_UV[1]) }, // top right
-			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[2], m_UV[3]) }, // bottom right
-			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[4], m_UV[5]) }, // bottom left
-			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[6], m_UV[7]) }  // top left
-		};
+			return;
+		}
 
-		m_RenderComponent->EditVertexData(m_VerticesIndex, vertices.data(), vertices.size());
+		if (m_Dirty)
+		{
+			m_Build();
+		}
+
+		if (m_QuadCount != 0)
+		{
+			m_RenderComponent->OnUpdate();
+		}
 	}
-	void SpriteComponent::SetSpriteTextureID(int textureID)
+	void TextComponent::OnEvent(Event* event, WindowComponent* windowComponent)
 	{
-		m_TextureAtlasComponent->GetUV(textureID, m_UV);
+	}
+	void TextComponent::OnExit()
+	{
+		if (m_RenderComponent)
+		{
+			m_RenderComponent->OnExit();
+			m_Page->OnExit();
+		}
 
-		std::vector<RenderComponent::Vertex> vertices =
+		Assets::Release(m_Font);
+
+		delete m_Data;
+	}
+
+	class ParticleEmitterComponent::Data
+	{
+	public:
+		Data() = default;
+		~Data() = default;
+
+		std::string& GetUUID()
 		{
-			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[0], m_UV[1]) }, // top right
-			{ RenderComponent::Vertex(m_X + ( m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[2], m_UV[3]) }, // bottom right
-			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + (-m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[4], m_UV[5]) }, // bottom left
-			{ RenderComponent::Vertex(m_X + (-m_Width / 2), m_Y + ( m_Height / 2), m_Z, m_Colour.x, m_Colour.y, m_Colour.z, m_UV[6], m_UV[7]) }  // top left
-		};
+			return m_UUID;
+		}
+
+		ParticleSettings& GetSettings()
+		{
+			return m_Settings;
+		}
+
+		Particles::Emitter*& GetEmitter()
+		{
+			return m_Emitter;
+		}
+
+	private:
+		std::string m_UUID;
+
+		ParticleSettings m_Settings;
+
+		Particles::Emitter* m_Emitter = nullptr;
+	};
+
+	ParticleEmitterComponent::ParticleEmitterComponent(Camera3DComponent* cameraComponent, Texture2DComponent* texture2DComponent, uint32_t capacity, const ParticleSettings& settings)
+		: m_CameraComponent(cameraComponent), m_Texture2DComponent(texture2DComponent), m_Capacity(capacity)
+	{
+		m_Data = new Data();
+
+		UUID uuid;
+
+		uuid.GenerateUUID();
 
-		m_RenderComponent->EditVertexData(m_VerticesIndex, vertices.data(), vertices.size());
+		m_Data->GetUUID() = uuid.GetUUIDString();
+		m_Data->GetSettings() = settings;
+
+		m_Data->GetEmitter() = Particles::CreateEmitter(capacity);
 	}
 
-	void SpriteComponent::OnUpdate()
+	void ParticleEmitterComponent::SetSettings(const ParticleSettings& settings)
 	{
-		m_RenderComponent->OnUpdate();
+		m_Data->GetSettings() = settings;
 	}
-	void SpriteComponent::OnEvent(Event* event, WindowComponent* windowComponent)
+
+	void ParticleEmitterComponent::SetPosition(vec3 position)
 	{
-		m_RenderComponent->OnEvent(event, windowComponent);
+		m_Position = position;
 	}
-	void SpriteComponent::OnExit()
+
+	void ParticleEmitterComponent::Burst(uint32_t count)
 	{
-		m_RenderComponent->OnExit();
+		m_BurstCount += count;
+	}
 
-		delete m_Data;
+	ParticleSettings& ParticleEmitterComponent::GetSettings()
+	{
+		return m_Data->GetSettings();
 	}
 
-	const char* SpriteComponent::GetUUID()
+	const char* ParticleEmitterComponent::GetUUID()
 	{
 		return m_Data->GetUUID().c_str();
-	}	
+	}
+
+	void ParticleEmitterComponent::OnUpdate()
+	{
+		Particles::Emitter* emitter = m_Data->GetEmitter();
+
+		if (!Particles::IsReady(emitter))
+		{
+			return;
+		}
+
+		ParticleSettings& settings = m_Data->GetSettings();
+
+		float deltaTime = static_cast<float>(Engine::GetFrameTime());
+
+		float emit = settings.emitRate * deltaTime + m_EmitRemainder;
+
+		uint32_t emitCount = static_cast<uint32_t>(emit);
+
+		m_EmitRemainder = emit - static_cast<float>(emitCount);
+
+		emitCount = std::min(emitCount + m_BurstCount, m_Capacity);
+		m_BurstCount = 0;
+
+		Particles::Parameters parameters =
+		{
+			{ m_Position.x, m_Position.y, m_Position.z, deltaTime },
+			{ settings.positionSpread.x, settings.positionSpread.y, settings.positionSpread.z, 0.0f },
+			{ settings.velocity.x, settings.velocity.y, settings.velocity.z, settings.lifetime },
+			{ settings.velocitySpread.x, settings.velocitySpread.y, settings.velocitySpread.z, settings.lifetimeSpread },
+			{ settings.gravity.x, settings.gravity.y, settings.gravity.z, 0.0f },
+			{ settings.startColour.x, settings.startColour.y, settings.startColour.z, settings.startAlpha },
+			{ settings.endColour.x, settings.endColour.y, settings.endColour.z, settings.endAlpha },
+			{ settings.startSize, settings.endSize, 0.0f, 0.0f },
+			emitCount, m_Capacity, m_Frame++ * 0x9E3779B9u, 0
+		};
+
+		Particles::Simulate(emitter, parameters);
+		Particles::Draw(emitter, m_CameraComponent->GetProjectionMatrix(), m_CameraComponent->GetViewMatrix(), m_Texture2DComponent ? m_Texture2DComponent->GetID() : 0);
+	}
+
+	void ParticleEmitterComponent::OnEvent(Event* event, WindowComponent* windowComponent)
+	{
+	}
+
+	void ParticleEmitterComponent::OnExit()
+	{
+		Particles::DestroyEmitter(m_Data->GetEmitter());
+
+		delete m_Data;
+	}
 }
\ No newline at end of file
@@ -1,7 +1,13 @@
 #pragma once
 
 //TODO: Potentially not include this?
+#include <string>
+#include <vector>
+
 #include "Types.h"
+#include "Sampler.h"
+#include "VertexLayout.h"
+#include "MeshOptimizer.h"
 
 namespace Velkro
 {
@@ -9,6 +15,15 @@ namespace Velkro
 	class Event;
 	class WindowComponent;
 	class UUID;
+	class AtlasBuilder;
+	struct UVRect;
+
+	namespace Assets
+	{
+		struct Texture2DAsset;
+		struct ShaderAsset;
+		struct FontAsset;
+	}
 
 	enum ComponentType
 	{
@@ -19,6 +34,7 @@ namespace Velkro
 	{
 	public:
 		virtual void OnUpdate() = 0;
+		virtual void OnFixedUpdate() {}; // Called before every simulation step, OnUpdate is called once per rendered frame.
 		virtual void OnEvent(Event* event, WindowComponent* windowComponent) {};
 		virtual void OnExit() = 0;
 
@@ -60,13 +76,18 @@ namespace Velkro
 	class ShaderComponent : public Component
 	{
 	public:
-		ShaderComponent(const char* vertexShaderPath, const char* fragmentShaderPath);
+		ShaderComponent(const char* vertexShaderPath, const char* fragmentShaderPath, const std::vector<std::string>& defines = {}); // Usable once IsLoaded, the compile runs in the background.
+		ShaderComponent(const char* cookedShaderPath);
 
 		void SetUniformMat4(const char* id, float* mat4);
 		void SetUniformVec3(const char* id, vec3 vec3);
 
 		void Bind();
 
+		uint32_t GetID();
+
+		bool IsLoaded();
+
 		const char* GetUUID() override;
 
 		void OnUpdate() override;
@@ -77,19 +98,22 @@ namespace Velkro
 		class Data;
 		Data* m_Data;
 
-		uint32_t m_ID;
-
-		const char* m_VertexShaderPath;
-		const char* m_FragmentShaderPath;
+		Assets::ShaderAsset* m_Asset; // Shared with every shader component loading the same files.
 	};
 
 	class Texture2DComponent : public Component
 	{
 	public:
-		Texture2DComponent(const char* texturePath, bool linear);
+		Texture2DComponent(const char* texturePath, const Sampler& sampler, bool async = false); // Async textures use a placeholder until they finish streaming in.
+		Texture2DComponent(const char* texturePath, bool linear, bool async = false);
+		Texture2DComponent(Assets::Texture2DAsset* asset); // Shares a texture that is already in the asset cache, like an atlas page.
 
 		void Bind();
 
+		uint32_t GetID();
+
+		bool IsLoaded();
+
 		int GetWidth();
 		int GetHeight();
 		int GetChannels();
@@ -101,11 +125,7 @@ namespace Velkro
 		void OnExit() override;
 
 	private:
-		uint32_t m_ID;
-
-		int m_Width;
-		int m_Height;
-		int m_Channels;
+		Assets::Texture2DAsset* m_Asset; // Shared with every texture component loading the same path and sampler.
 
 		class Data;
 		Data* m_Data;
@@ -114,11 +134,16 @@ namespace Velkro
 	class TextureAtlasComponent : public Component
 	{
 	public:
+		TextureAtlasComponent(const char* textureAtlasPath, const Sampler& sampler, int texureWidth, int textureHeight); // A tile size of 0 uses the one stored in a cooked atlas, or the whole image as one tile without one.
 		TextureAtlasComponent(const char* textureAtlasPath, bool linear, int texureWidth, int textureHeight);
+		TextureAtlasComponent(AtlasBuilder* atlasBuilder, int page = 0); // Texture IDs are the builder's image indices, only images packed on this page can be used.
 
 		void Bind();
 
-		void GetUV(int textureID, float* UV);
+		void GetUV(int textureID, float* UV); // Reads the UV table built at load, no tile math per call.
+
+		int GetTextureCount();
+		const UVRect* GetUVs(); // GetTextureCount entries, indexed by texture ID.
 
 		Texture2DComponent* GetTexture();
 
@@ -138,6 +163,8 @@ namespace Velkro
 
 		int m_TextureWidth;
 		int m_TextureHeight;
+
+		void m_UpdateGridUVs(); // Helper function for GetUV, cuts the table again whenever the atlas size changes.
 	};
 
 	class Camera3DComponent : public Component
@@ -166,25 +193,28 @@ namespace Velkro
 		Data* m_Data;
 	};
 
-	class RenderComponent : public Component
+	// Templated on the vertex layout, the VAO is set up from the layout's attribute list. RenderComponent and
+	// PackedRenderComponent are instantiated in Component.cpp, other layouts need an instantiation there as well.
+	template<typename Layout>
+	class BasicRenderComponent : public Component
 	{
 	public:
-		struct Vertex
-		{
-			float x, y, z;
-			float r, g, b;
-			float uvX, uvY;
-		};
+		using Vertex = Layout;
+
+		static_assert(sizeof(Vertex) == Vertex::Attributes::stride, "Vertex layouts can't have padding their attribute list doesn't describe.");
 
 		struct Index
 		{
 			uint32_t a, b, c;
 		};
 
-		RenderComponent(WindowComponent* windowComponent, ShaderComponent* shaderComponent, Texture2DComponent* texture);
+		BasicRenderComponent(WindowComponent* windowComponent, ShaderComponent* shaderComponent, Texture2DComponent* texture);
 
 		size_t AddData(Vertex* vertices, size_t verticesCount, Index* indices, size_t indicesCount);
 		void EditVertexData(size_t startIndex, Vertex* newVertices, size_t newVertexCount);
+		void EditVertexUVs(size_t startIndex, const float* UVs, size_t vertexCount); // Writes only the UVs, given as two floats per vertex.
+
+		Vertex* SetQuadCount(size_t quadCount); // For components holding only quads, resizes them and returns the vertices to be written in place.
 
 		void OnUpdate() override;
 		void OnEvent(Event* event, WindowComponent* windowComponent) override;
@@ -215,6 +245,135 @@ namespace Velkro
 		Data* m_Data;
 	};
 
+	using RenderComponent = BasicRenderComponent<DefaultVertex>;
+	using PackedRenderComponent = BasicRenderComponent<PackedVertex>; // Half the vertex size of RenderComponent.
+
+	extern template class BasicRenderComponent<DefaultVertex>;
+	extern template class BasicRenderComponent<PackedVertex>;
+
+	// Meshes of one vertex layout kept together in large shared buffers and drawn with one glMultiDrawElementsIndirect per
+	// shader and texture pair, however many meshes are queued. The vertex shader reads each draw's data from the shader
+	// storage buffer at binding 0 through gl_DrawID:
+	//
+	//     struct DrawData { mat4 transform; uvec4 material; };
+	//     layout(std430, binding = 0) readonly buffer Draws { DrawData draws[]; };
+	//
+	// Capacities are fixed on creation, meshes that no longer fit are refused.
+	template<typename Layout>
+	class BasicMeshBatchComponent : public Component
+	{
+	public:
+		using Vertex = Layout;
+		using Index = typename BasicRenderComponent<Layout>::Index;
+
+		static constexpr uint32_t InvalidMesh = 0xFFFFFFFF;
+
+		struct DrawData
+		{
+			float transform[16];
+			uint32_t material[4]; // x is the material index, the rest is left to the shader.
+		};
+
+		BasicMeshBatchComponent(size_t vertexCapacity, size_t indexCapacity, size_t drawCapacity); // Index capacity is in triangles, like AddData.
+
+		uint32_t AddMesh(const Vertex* vertices, size_t verticesCount, const Index* indices, size_t indicesCount); // Indices start at 0 for every mesh.
+		void EditMesh(uint32_t mesh, size_t startIndex, const Vertex* newVertices, size_t newVertexCount); // Rewrites vertices of dynamic meshes in place.
+		void RemoveMesh(uint32_t mesh);
+
+		void Draw(uint32_t mesh, ShaderComponent* shaderComponent, Texture2DComponent* textureComponent, const float* transform = nullptr, uint32_t material = 0); // Queued until OnUpdate, a null transform is the identity.
+
+		// Moves visibility to a compute pass (see Culling.h) testing each queued draw against the camera's frustum, and with
+		// occlusion against the depth drawn up to this batch last frame. A null camera draws everything again.
+		void SetCulling(Camera3DComponent* cameraComponent, bool occlusion = false);
+
+		size_t GetMeshCount();
+		size_t GetDrawCallCount(); // Multi draws recorded by the last OnUpdate.
+
+		const char* GetUUID() override;
+
+		void OnUpdate() override;
+		void OnEvent(Event* event, WindowComponent* windowComponent) override;
+		void OnExit() override;
+
+	private:
+		uint32_t m_VAO = 0, m_VBO = 0, m_EBO = 0;
+		uint32_t m_IndirectBuffer = 0, m_DrawBuffer = 0;
+
+		size_t m_DrawCapacity;
+		size_t m_DrawAlignment = 1; // In draws, so every group's data can be bound with glBindBufferRange.
+
+		size_t m_DrawCallCount = 0;
+
+		Camera3DComponent* m_CameraComponent = nullptr;
+		bool m_Occlusion = false;
+
+		class Data;
+		Data* m_Data;
+	};
+
+	using MeshBatchComponent = BasicMeshBatchComponent<DefaultVertex>;
+	using PackedMeshBatchComponent = BasicMeshBatchComponent<PackedVertex>;
+
+	extern template class BasicMeshBatchComponent<DefaultVertex>;
+	extern template class BasicMeshBatchComponent<PackedVertex>;
+
+	// Static mesh in GPU buffers, processed once when its data is set (see MeshOptimizer.h). Duplicate vertices are welded,
+	// triangles reordered for the post-transform cache and overdraw, vertices reordered for fetch, and indices stored as
+	// 16 bit whenever the vertex count allows. Lower LODs share the vertex buffer and are picked each frame from how large
+	// the mesh's bounds project on screen. The transform is uploaded as u_Model before each draw.
+	// Meshes cooked by VelkroCook (.vmesh) went through the same processing offline, Load maps them and hands the
+	// buffers straight to GL.
+	template<typename Layout>
+	class BasicMeshComponent : public Component
+	{
+	public:
+		using Vertex = Layout;
+		using Index = typename BasicRenderComponent<Layout>::Index;
+
+		BasicMeshComponent(ShaderComponent* shaderComponent, Texture2DComponent* textureComponent, Camera3DComponent* cameraComponent); // Without a camera the full mesh is always drawn.
+
+		bool SetData(const Vertex* vertices, size_t verticesCount, const Index* indices, size_t indicesCount, const MeshOptions& options = MeshOptions()); // Creates GL buffers, so not while the frame pipeline runs.
+		bool Load(const char* path); // Same as SetData.
+		void SetTransform(const float* transform);
+
+		int GetLODCount();
+		int GetCurrentLOD(); // Drawn by the last OnUpdate.
+
+		size_t GetVertexCount();
+		size_t GetTriangleCount(int lod = 0);
+		size_t GetIndexSize(); // 2 or 4 bytes.
+
+		const char* GetUUID() override;
+
+		void OnUpdate() override;
+		void OnEvent(Event* event, WindowComponent* windowComponent) override;
+		void OnExit() override;
+
+	private:
+		ShaderComponent* m_ShaderComponent;
+		Texture2DComponent* m_TextureComponent;
+		Camera3DComponent* m_CameraComponent;
+
+		uint32_t m_VAO = 0, m_VBO = 0, m_EBO = 0;
+
+		size_t m_VertexCount = 0;
+		size_t m_IndexSize = 4;
+
+		int m_CurrentLOD = 0;
+
+		void m_CreateBuffers(const void* vertices, size_t vertexCount, const void* indices, size_t indexCount, size_t indexSize); // Helper functions for SetData, Load and OnExit.
+		void m_DeleteBuffers();
+
+		class Data;
+		Data* m_Data;
+	};
+
+	using MeshComponent = BasicMeshComponent<DefaultVertex>;
+	using PackedMeshComponent = BasicMeshComponent<PackedVertex>;
+
+	extern template class BasicMeshComponent<DefaultVertex>;
+	extern template class BasicMeshComponent<PackedVertex>;
+
 	class SpriteComponent : public Component
 	{
 	public:
@@ -230,6 +389,7 @@ namespace Velkro
 		void SetSpriteTextureID(int textureID);
 
 		void OnUpdate() override;
+		void OnFixedUpdate() override;
 		void OnEvent(Event* event, WindowComponent* windowComponent) override;
 		void OnExit() override;
 
@@ -246,8 +406,230 @@ namespace Velkro
 		float m_Width, m_Height;
 		float m_X, m_Y, m_Z;
 		vec3 m_Colour = vec3(1.0f, 1.0f, 1.0f);
+
+		float m_PreviousX = 0.0f, m_PreviousY = 0.0f, m_PreviousZ = 0.0f; // Position at the start of the current simulation step, used for interpolation.
+
+		bool m_Interpolated = false;
 		
-		float* m_UV;
+		float* m_UV = nullptr;
+
+		int m_TextureID = -1;
+
+		void m_WriteVertices(float x, float y, float z); // Helper function for OnUpdate, writes the sprite at a position without changing it.
+
+		class Data;
+		Data* m_Data;
+	};
+
+	struct AnimationClip
+	{
+		std::vector<int> frames; // Texture IDs in the atlas of the animated sprites.
+		std::vector<float> durations; // Seconds per frame, a single entry is used for every frame.
+
+		bool loop = true;
+	};
+
+	// Animates any number of atlas sprites in one pass over flat clip and playback arrays per frame.
+	// Sprites only have their UVs rewritten when their frame actually changes.
+	class SpriteAnimationComponent : public Component
+	{
+	public:
+		SpriteAnimationComponent();
+
+		int AddClip(const AnimationClip& clip);
+		int AddSprite(SpriteComponent* spriteComponent, int clip, float speed = 1.0f); // Returns the index used to control the sprite.
+
+		void Play(int sprite, int clip); // Restarts from the first frame.
+		void SetSpeed(int sprite, float speed); // A speed of 0 pauses the sprite.
+
+		bool IsFinished(int sprite); // True once a clip that doesn't loop reached its last frame.
+
+		void Advance(float seconds); // Called by OnUpdate with the frame time.
+
+		const char* GetUUID() override;
+
+		void OnUpdate() override;
+		void OnEvent(Event* event, WindowComponent* windowComponent) override;
+		void OnExit() override;
+
+	private:
+		class Data;
+		Data* m_Data;
+	};
+
+	// Sprite attributes as one array each, so batches can be filled straight from particle or simulation data.
+	struct SpriteArrays
+	{
+		const float* x;
+		const float* y;
+		const float* z;
+
+		const float* width;
+		const float* height;
+
+		const float* r;
+		const float* g;
+		const float* b;
+
+		const int* textureIDs; // Indices into the atlas UV table.
+	};
+
+	// Draws many atlas sprites as one set of quads, generated in bulk with AVX2 instead of through a SpriteComponent each.
+	// The shader sees the same vertex layout as RenderComponent.
+	class SpriteBatchComponent : public Component
+	{
+	public:
+		SpriteBatchComponent(WindowComponent* windowComponent, ShaderComponent* shaderComponent, TextureAtlasComponent* textureAtlasComponent);
+
+		void SetSprites(const SpriteArrays& sprites, size_t count); // Replaces every sprite in the batch, which keeps drawing them until the next call.
+
+		size_t GetSpriteCount();
+
+		const char* GetUUID() override;
+
+		void OnUpdate() override;
+		void OnEvent(Event* event, WindowComponent* windowComponent) override;
+		void OnExit() override;
+
+	private:
+		ShaderComponent* m_ShaderComponent;
+		TextureAtlasComponent* m_TextureAtlasComponent;
+
+		// Owned rather than shared with RenderComponent, quads are generated straight into the upload command's payload and
+		// the index pattern is only rebuilt when the batch grows.
+		uint32_t m_VAO = 0, m_VBO = 0, m_EBO = 0;
+
+		size_t m_SpriteCount = 0;
+		size_t m_QuadCapacity = 0;
+
+		class Data;
+		Data* m_Data;
+	};
+
+	// Static tile layer drawn from per chunk vertex buffers. Chunks are only rebuilt when one of their tiles changes,
+	// and chunks outside the camera's view aren't drawn, so large maps cost one draw per visible chunk.
+	class TilemapComponent : public Component
+	{
+	public:
+		// Tile (0, 0) has its bottom left corner at position, rows go up. Without a camera every chunk is drawn.
+		TilemapComponent(ShaderComponent* shaderComponent, TextureAtlasComponent* textureAtlasComponent, Camera3DComponent* cameraComponent, int width, int height, float tileSize, vec3 position = vec3(0.0f, 0.0f, 0.0f), int chunkSize = 32);
+
+		void SetTile(int column, int row, int textureID); // A texture ID below 0 leaves the tile empty.
+		void SetTiles(const int* textureIDs); // Width times height IDs, row by row from the bottom.
+
+		int GetTile(int column, int row);
+
+		int GetDrawnChunkCount(); // Chunks that passed culling last frame.
+
+		const char* GetUUID() override;
+
+		void OnUpdate() override;
+		void OnEvent(Event* event, WindowComponent* windowComponent) override;
+		void OnExit() override;
+
+	private:
+		ShaderComponent* m_ShaderComponent;
+		TextureAtlasComponent* m_TextureAtlasComponent;
+		Camera3DComponent* m_CameraComponent;
+
+		void m_BuildChunk(size_t chunk); // Helper function for OnUpdate, uploads the quads of the chunk's tiles.
+
+		class Data;
+		Data* m_Data;
+	};
+
+	// UTF-8 text drawn from a font's distance field page as a single batch, the shader has to threshold the alpha (see Font.h).
+	// Sizes are in world units and scale freely, glyphs are only rasterized once per font.
+	class TextComponent : public Component
+	{
+	public:
+		TextComponent(WindowComponent* windowComponent, ShaderComponent* shaderComponent, const char* fontPath, const char* text, float size, vec3 colour, float x, float y, float z); // x and y are the start of the first baseline.
+
+		void SetText(const char* text);
+		void SetSize(float size);
+		void SetPosition(float x, float y, float z);
+		void SetColour(vec3 colour);
+
+		float GetWidth(); // Of the widest line.
+
+		const char* GetUUID() override;
+
+		void OnUpdate() override;
+		void OnEvent(Event* event, WindowComponent* windowComponent) override;
+		void OnExit() override;
+
+	private:
+		RenderComponent* m_RenderComponent;
+		Texture2DComponent* m_Page;
+
+		Assets::FontAsset* m_Font;
+
+		float m_Size;
+		float m_X, m_Y, m_Z;
+		vec3 m_Colour;
+
+		size_t m_QuadCount = 0;
+
+		bool m_Dirty = true;
+
+		void m_Build(); // Helper function for OnUpdate, lays the text out again and rewrites its quads.
+
+		class Data;
+		Data* m_Data;
+	};
+
+	struct ParticleSettings
+	{
+		float emitRate = 100.0f; // Particles per second.
+
+		float lifetime = 2.0f;
+		float lifetimeSpread = 0.5f;
+
+		vec3 positionSpread = { 0.0f, 0.0f, 0.0f };
+		vec3 velocity = { 0.0f, 1.0f, 0.0f };
+		vec3 velocitySpread = { 0.5f, 0.5f, 0.5f };
+		vec3 gravity = { 0.0f, -9.81f, 0.0f };
+
+		vec3 startColour = { 1.0f, 1.0f, 1.0f };
+		vec3 endColour = { 1.0f, 1.0f, 1.0f };
+		float startAlpha = 1.0f;
+		float endAlpha = 0.0f;
+
+		float startSize = 0.1f;
+		float endSize = 0.1f;
+	};
+
+	// Camera facing particles simulated and drawn entirely on the GPU (see Particles.h), so capacity can run into the millions.
+	// Particles past capacity are dropped until older ones die.
+	class ParticleEmitterComponent : public Component
+	{
+	public:
+		ParticleEmitterComponent(Camera3DComponent* cameraComponent, Texture2DComponent* texture2DComponent, uint32_t capacity, const ParticleSettings& settings = ParticleSettings()); // Without a texture particles are soft dots.
+
+		void SetSettings(const ParticleSettings& settings);
+		void SetPosition(vec3 position);
+
+		void Burst(uint32_t count); // Emitted on top of the rate next update.
+
+		ParticleSettings& GetSettings();
+
+		const char* GetUUID() override;
+
+		void OnUpdate() override;
+		void OnEvent(Event* event, WindowComponent* windowComponent) override;
+		void OnExit() override;
+
+	private:
+		Camera3DComponent* m_CameraComponent;
+		Texture2DComponent* m_Texture2DComponent;
+
+		uint32_t m_Capacity;
+
+		vec3 m_Position = { 0.0f, 0.0f, 0.0f };
+
+		float m_EmitRemainder = 0.0f; // Fraction of a particle carried over between frames.
+		uint32_t m_BurstCount = 0;
+		uint32_t m_Frame = 0;
 
 		class Data;
 		Data* m_Data;
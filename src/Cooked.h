@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+
+// Layout of the blobs written by VelkroCook, shared by the tool and the runtime loaders.
+// Bump Version whenever a layout changes so stale blobs are rejected instead of misread.
+namespace Velkro::Cooked
+{
+	static constexpr uint32_t Version = 1;
+
+	static constexpr uint32_t TextureMagic = 0x58455456; // "VTEX"
+	static constexpr uint32_t ShaderMagic = 0x44485356; // "VSHD"
+	static constexpr uint32_t MeshMagic = 0x48534D56; // "VMSH"
+
+	struct TextureHeader
+	{
+		uint32_t magic = TextureMagic;
+		uint32_t version = Version;
+
+		uint32_t internalFormat; // GL internal format.
+		uint32_t format; // GL pixel format, 0 for block compressed data.
+		uint32_t compressed;
+
+		int32_t width, height;
+
+		uint32_t levelCount;
+
+		int32_t tileWidth = 0, tileHeight = 0; // Atlas tile size, 0 if the texture isn't an atlas.
+	};
+
+	// Follows the texture header once per level, offsets are from the start of the blob.
+	struct TextureLevel
+	{
+		uint64_t offset, size;
+		int32_t width, height;
+	};
+
+	// Followed by the preprocessed vertex and fragment sources, each null terminated.
+	struct ShaderHeader
+	{
+		uint32_t magic = ShaderMagic;
+		uint32_t version = Version;
+
+		uint32_t vertexSize, fragmentSize; // Including the null terminator.
+	};
+
+	static constexpr uint32_t MaxMeshAttributes = 8;
+
+	// One vertex attribute, as in AttributeDescription. Loaders only accept blobs whose layout matches their vertex type.
+	struct MeshAttribute
+	{
+		uint32_t type; // GL type enum.
+		uint32_t count;
+		uint32_t normalized;
+		uint32_t offset;
+	};
+
+	// Followed by lodCount MeshRange entries and then submeshCount entries per LOD, LOD 0 first. The vertex and index
+	// blobs are 16 byte aligned and stored exactly as they go into the GPU buffers, offsets are from the start of the blob.
+	struct MeshHeader
+	{
+		uint32_t magic = MeshMagic;
+		uint32_t version = Version;
+
+		uint32_t vertexSize;
+		uint32_t attributeCount;
+		MeshAttribute attributes[MaxMeshAttributes];
+
+		uint32_t indexSize; // 2 or 4 bytes.
+		uint32_t lodCount, submeshCount;
+		uint32_t padding = 0;
+
+		float centre[3], radius; // Bounding sphere.
+
+		uint64_t vertexCount, vertexOffset;
+		uint64_t indexCount, indexOffset;
+	};
+
+	// Index range of a LOD or submesh, screenSize is only used by LODs.
+	struct MeshRange
+	{
+		uint32_t firstIndex, indexCount;
+		float screenSize;
+		uint32_t padding = 0;
+	};
+}
\ No newline at end of file
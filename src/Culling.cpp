@@ -0,0 +1,499 @@
+#include "Culling.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "Renderer.h"
+#include "CommandBuffer.h"
+#include "FramePipeline.h"
+#include "Image.h"
+#include "Log.h"
+
+namespace Velkro::Culling
+{
+	struct Culler
+	{
+		size_t capacity;
+
+		uint32_t cullProgram, copyProgram, reduceProgram;
+
+		uint32_t candidateBuffer;
+		uint32_t stateBuffer; // Indirect dispatch size followed by one draw count per group.
+		uint32_t parameterBuffer;
+
+		uint32_t indirectBuffer, drawBuffer; // Owned by the caller.
+
+		// Only touched on the main thread.
+		std::vector<uint32_t> state;
+		float viewProjection[16];
+		float pyramidViewProjection[16]; // Camera the pyramid's depth was drawn with.
+
+		// Only touched on the context thread.
+		uint32_t depthTexture = 0, pyramidTexture = 0;
+		int pyramidWidth = 0, pyramidHeight = 0, pyramidLevels = 0;
+	};
+
+	// Laid out like the std140 block of the cull pass.
+	struct CullParameters
+	{
+		float previousViewProjection[16];
+		float planes[6][4];
+
+		uint32_t candidateCount;
+		uint32_t occlusion;
+		uint32_t padding[2];
+	};
+
+	static_assert(sizeof(Candidate) == 128, "Candidates have to match the std430 layout of the cull pass.");
+
+	static constexpr size_t StateHeaderSize = 4 * sizeof(uint32_t);
+
+	static const char* CullSource = R"(#version 460 core
+
+#if defined(CULL)
+layout(local_size_x = 64) in;
+
+struct DrawData
+{
+	mat4 transform;
+	uvec4 material;
+};
+
+struct Candidate
+{
+	mat4 transform;
+	uvec4 material;
+	vec4 sphere;
+	uint count;
+	uint firstIndex;
+	int baseVertex;
+	uint group;
+	uint groupFirst;
+	uint padding0, padding1, padding2;
+};
+
+struct IndirectCommand
+{
+	uint count;
+	uint instanceCount;
+	uint firstIndex;
+	int baseVertex;
+	uint baseInstance;
+};
+
+layout(std140, binding = 0) uniform Parameters
+{
+	mat4 u_PreviousViewProjection;
+	vec4 u_Planes[6];
+	uvec4 u_Counts; // Candidate count, occlusion.
+};
+
+layout(std430, binding = 0) readonly buffer Candidates
+{
+	Candidate candidates[];
+};
+
+layout(std430, binding = 1) writeonly buffer Commands
+{
+	IndirectCommand commands[];
+};
+
+layout(std430, binding = 2) writeonly buffer Draws
+{
+	DrawData draws[];
+};
+
+layout(std430, binding = 3) buffer State
+{
+	uvec4 dispatch;
+	uint counts[];
+};
+
+layout(binding = 0) uniform sampler2D u_DepthPyramid;
+
+uniform int u_PyramidReady;
+
+bool IsOccluded(vec3 centre, float radius)
+{
+	vec3 minimum = vec3(1e30);
+	vec3 maximum = vec3(-1e30);
+
+	for (int i = 0; i < 8; i++)
+	{
+		vec3 corner = centre + radius * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);
+
+		vec4 clip = u_PreviousViewProjection * vec4(corner, 1.0);
+
+		// Bounds crossing the near plane can't be projected, they are kept.
+		if (clip.w <= 0.0)
+		{
+			return false;
+		}
+
+		vec3 ndc = clip.xyz / clip.w;
+
+		minimum = min(minimum, ndc);
+		maximum = max(maximum, ndc);
+	}
+
+	ivec2 size = textureSize(u_DepthPyramid, 0);
+
+	vec2 pixelMinimum = clamp(minimum.xy * 0.5 + 0.5, 0.0, 1.0) * vec2(size);
+	vec2 pixelMaximum = clamp(maximum.xy * 0.5 + 0.5, 0.0, 1.0) * vec2(size);
+
+	// The level where the bounds span at most two texels on each axis.
+	float extent = max(pixelMaximum.x - pixelMinimum.x, pixelMaximum.y - pixelMinimum.y);
+
+	int level = clamp(int(ceil(log2(max(extent, 1.0)))), 0, textureQueryLevels(u_DepthPyramid) - 1);
+
+	ivec2 levelSize = textureSize(u_DepthPyramid, level);
+	ivec2 first = min(ivec2(pixelMinimum) >> level, levelSize - 1);
+	ivec2 last = min(ivec2(pixelMaximum) >> level, levelSize - 1);
+
+	float farthest = 0.0;
+
+	for (int y = first.y; y <= last.y; y++)
+	{
+		for (int x = first.x; x <= last.x; x++)
+		{
+			farthest = max(farthest, texelFetch(u_DepthPyramid, ivec2(x, y), level).r);
+		}
+	}
+
+	return minimum.z * 0.5 + 0.5 > farthest;
+}
+
+void main()
+{
+	uint index = gl_GlobalInvocationID.x;
+
+	if (index >= u_Counts.x)
+	{
+		return;
+	}
+
+	Candidate candidate = candidates[index];
+
+	vec3 centre = (candidate.transform * vec4(candidate.sphere.xyz, 1.0)).xyz;
+
+	vec3 scales = vec3(dot(candidate.transform[0].xyz, candidate.transform[0].xyz), dot(candidate.transform[1].xyz, candidate.transform[1].xyz), dot(candidate.transform[2].xyz, candidate.transform[2].xyz));
+
+	float radius = candidate.sphere.w * sqrt(max(scales.x, max(scales.y, scales.z)));
+
+	for (int i = 0; i < 6; i++)
+	{
+		if (dot(u_Planes[i].xyz, centre) + u_Planes[i].w < -radius)
+		{
+			return;
+		}
+	}
+
+	if (u_Counts.y != 0u && u_PyramidReady != 0 && IsOccluded(centre, radius))
+	{
+		return;
+	}
+
+	uint slot = candidate.groupFirst + atomicAdd(counts[candidate.group], 1u);
+
+	commands[slot] = IndirectCommand(candidate.count, 1u, candidate.firstIndex, candidate.baseVertex, 0u);
+	draws[slot] = DrawData(candidate.transform, candidate.material);
+}
+#elif defined(PYRAMID_COPY)
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0) uniform sampler2D u_Depth;
+
+layout(r32f, binding = 0) writeonly uniform image2D u_Destination;
+
+void main()
+{
+	ivec2 coord = ivec2(gl_GlobalInvocationID.xy);
+
+	if (any(greaterThanEqual(coord, imageSize(u_Destination))))
+	{
+		return;
+	}
+
+	imageStore(u_Destination, coord, vec4(texelFetch(u_Depth, coord, 0).r));
+}
+#elif defined(PYRAMID_REDUCE)
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(r32f, binding = 0) readonly uniform image2D u_Source;
+layout(r32f, binding = 1) writeonly uniform image2D u_Destination;
+
+void main()
+{
+	ivec2 coord = ivec2(gl_GlobalInvocationID.xy);
+	ivec2 size = imageSize(u_Destination);
+
+	if (any(greaterThanEqual(coord, size)))
+	{
+		return;
+	}
+
+	ivec2 sourceSize = imageSize(u_Source);
+
+	// Levels round down, so the last texel of an odd sized level also covers the source's last row or column.
+	ivec2 extent = ivec2(coord.x == size.x - 1 && (sourceSize.x & 1) != 0 ? 3 : 2, coord.y == size.y - 1 && (sourceSize.y & 1) != 0 ? 3 : 2);
+
+	float depth = 0.0;
+
+	for (int y = 0; y < extent.y; y++)
+	{
+		for (int x = 0; x < extent.x; x++)
+		{
+			depth = max(depth, imageLoad(u_Source, min(coord * 2 + ivec2(x, y), sourceSize - 1)).r);
+		}
+	}
+
+	imageStore(u_Destination, coord, vec4(depth));
+}
+#endif
+)";
+
+	Culler* CreateCuller(size_t capacity, uint32_t indirectBuffer, uint32_t drawBuffer)
+	{
+		Culler* culler = new Culler();
+		culler->capacity = capacity;
+		culler->indirectBuffer = indirectBuffer;
+		culler->drawBuffer = drawBuffer;
+
+		culler->cullProgram = Renderer::LoadComputeShaderFromSource(CullSource, { "CULL" });
+		culler->copyProgram = Renderer::LoadComputeShaderFromSource(CullSource, { "PYRAMID_COPY" });
+		culler->reduceProgram = Renderer::LoadComputeShaderFromSource(CullSource, { "PYRAMID_REDUCE" });
+
+		glCreateBuffers(1, &culler->candidateBuffer);
+		glNamedBufferStorage(culler->candidateBuffer, capacity * sizeof(Candidate), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+		// Every draw can be a group of its own.
+		glCreateBuffers(1, &culler->stateBuffer);
+		glNamedBufferStorage(culler->stateBuffer, StateHeaderSize + capacity * sizeof(uint32_t), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+		glCreateBuffers(1, &culler->parameterBuffer);
+		glNamedBufferStorage(culler->parameterBuffer, sizeof(CullParameters), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+		std::memset(culler->viewProjection, 0, sizeof(culler->viewProjection));
+		std::memset(culler->pyramidViewProjection, 0, sizeof(culler->pyramidViewProjection));
+
+		return culler;
+	}
+
+	static void DeleteCuller(void* userData)
+	{
+		Culler* culler = static_cast<Culler*>(userData);
+
+		for (uint32_t program : { culler->cullProgram, culler->copyProgram, culler->reduceProgram })
+		{
+			Renderer::DeleteShader(program);
+		}
+
+		glDeleteBuffers(1, &culler->candidateBuffer);
+		glDeleteBuffers(1, &culler->stateBuffer);
+		glDeleteBuffers(1, &culler->parameterBuffer);
+
+		glDeleteTextures(1, &culler->depthTexture);
+		glDeleteTextures(1, &culler->pyramidTexture);
+
+		delete culler;
+	}
+
+	void DestroyCuller(Culler* culler)
+	{
+		if (FramePipeline::IsRunning())
+		{
+			CommandBuffer::Get().Call(DeleteCuller, culler);
+		}
+		else
+		{
+			DeleteCuller(culler);
+		}
+	}
+
+	bool IsReady(Culler* culler)
+	{
+		for (uint32_t program : { culler->cullProgram, culler->copyProgram, culler->reduceProgram })
+		{
+			if (Renderer::GetShaderStatus(program) != Renderer::ShaderLinked)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	static void RunCulling(void* userData)
+	{
+		Culler* culler = static_cast<Culler*>(userData);
+
+		glUseProgram(culler->cullProgram);
+		glProgramUniform1i(culler->cullProgram, glGetUniformLocation(culler->cullProgram, "u_PyramidReady"), culler->pyramidTexture != 0);
+
+		glBindBufferBase(GL_UNIFORM_BUFFER, 0, culler->parameterBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, culler->candidateBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, culler->indirectBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, culler->drawBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, culler->stateBuffer);
+		glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, culler->stateBuffer);
+
+		glBindTextureUnit(0, culler->pyramidTexture);
+
+		glDispatchComputeIndirect(0);
+
+		// The draws read the commands and their counts as indirect parameters and the draw data from the vertex shader.
+		glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+		glBindTextureUnit(0, 0);
+
+		for (uint32_t binding = 0; binding < 4; binding++)
+		{
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, 0);
+		}
+
+		glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+		glUseProgram(0);
+	}
+
+	static void RunPyramid(void* userData)
+	{
+		Culler* culler = static_cast<Culler*>(userData);
+
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+
+		int width = viewport[2];
+		int height = viewport[3];
+
+		if (width <= 0 || height <= 0)
+		{
+			return;
+		}
+
+		if (width != culler->pyramidWidth || height != culler->pyramidHeight)
+		{
+			glDeleteTextures(1, &culler->depthTexture);
+			glDeleteTextures(1, &culler->pyramidTexture);
+
+			culler->pyramidWidth = width;
+			culler->pyramidHeight = height;
+			culler->pyramidLevels = Image::GetMipLevelCount(width, height);
+
+			glCreateTextures(GL_TEXTURE_2D, 1, &culler->depthTexture);
+			glTextureStorage2D(culler->depthTexture, 1, GL_DEPTH_COMPONENT32F, width, height);
+
+			glCreateTextures(GL_TEXTURE_2D, 1, &culler->pyramidTexture);
+			glTextureStorage2D(culler->pyramidTexture, culler->pyramidLevels, GL_R32F, width, height);
+			glTextureParameteri(culler->pyramidTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+			glTextureParameteri(culler->pyramidTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		}
+
+		// The default framebuffer's depth can't be sampled, copying it converts it to a float texture on the way.
+		glCopyTextureSubImage2D(culler->depthTexture, 0, 0, 0, viewport[0], viewport[1], width, height);
+
+		glUseProgram(culler->copyProgram);
+		glBindTextureUnit(0, culler->depthTexture);
+		glBindImageTexture(0, culler->pyramidTexture, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+		glDispatchCompute((width + 7) / 8, (height + 7) / 8, 1);
+
+		glUseProgram(culler->reduceProgram);
+
+		for (int level = 1; level < culler->pyramidLevels; level++)
+		{
+			glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+			glBindImageTexture(0, culler->pyramidTexture, level - 1, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+			glBindImageTexture(1, culler->pyramidTexture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+			int levelWidth = std::max(1, width >> level);
+			int levelHeight = std::max(1, height >> level);
+
+			glDispatchCompute((levelWidth + 7) / 8, (levelHeight + 7) / 8, 1);
+		}
+
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+		glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+		glBindImageTexture(1, 0, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32F);
+		glBindTextureUnit(0, 0);
+		glUseProgram(0);
+	}
+
+	void Cull(Culler* culler, const Candidate* candidates, size_t candidateCount, size_t groupCount, const float* viewProjection, bool occlusion)
+	{
+		if (candidateCount > culler->capacity)
+		{
+			VLK_CORE_ERROR("Culling {} candidates with room for {}, the rest are skipped.", candidateCount, culler->capacity);
+
+			candidateCount = culler->capacity;
+		}
+
+		CullParameters parameters;
+
+		std::memcpy(parameters.previousViewProjection, culler->pyramidViewProjection, sizeof(parameters.previousViewProjection));
+
+		// Planes from the rows of the view projection matrix, normalized so distances to them are in world units.
+		for (int plane = 0; plane < 6; plane++)
+		{
+			int row = plane / 2;
+			float sign = plane % 2 == 0 ? 1.0f : -1.0f;
+
+			float length = 0.0f;
+
+			for (int column = 0; column < 4; column++)
+			{
+				parameters.planes[plane][column] = viewProjection[column * 4 + 3] + sign * viewProjection[column * 4 + row];
+
+				if (column < 3)
+				{
+					length += parameters.planes[plane][column] * parameters.planes[plane][column];
+				}
+			}
+
+			length = std::sqrt(length);
+
+			for (int column = 0; column < 4; column++)
+			{
+				parameters.planes[plane][column] /= length > 0.0f ? length : 1.0f;
+			}
+		}
+
+		parameters.candidateCount = static_cast<uint32_t>(candidateCount);
+		parameters.occlusion = occlusion ? 1 : 0;
+		parameters.padding[0] = parameters.padding[1] = 0;
+
+		std::memcpy(culler->viewProjection, viewProjection, sizeof(culler->viewProjection));
+
+		// The counts are cleared with the same upload that sets the dispatch size.
+		culler->state.assign(StateHeaderSize / sizeof(uint32_t) + groupCount, 0);
+		culler->state[0] = static_cast<uint32_t>((candidateCount + 63) / 64);
+		culler->state[1] = 1;
+		culler->state[2] = 1;
+
+		CommandBuffer::Get().UploadBuffer(GL_SHADER_STORAGE_BUFFER, culler->candidateBuffer, 0, candidates, candidateCount * sizeof(Candidate));
+		CommandBuffer::Get().UploadBuffer(GL_SHADER_STORAGE_BUFFER, culler->stateBuffer, 0, culler->state.data(), culler->state.size() * sizeof(uint32_t));
+		CommandBuffer::Get().UploadBuffer(GL_UNIFORM_BUFFER, culler->parameterBuffer, 0, &parameters, sizeof(CullParameters));
+		CommandBuffer::Get().Call(RunCulling, culler);
+	}
+
+	void BuildDepthPyramid(Culler* culler)
+	{
+		std::memcpy(culler->pyramidViewProjection, culler->viewProjection, sizeof(culler->pyramidViewProjection));
+
+		CommandBuffer::Get().Call(RunPyramid, culler);
+	}
+
+	uint32_t GetCountBuffer(Culler* culler)
+	{
+		return culler->stateBuffer;
+	}
+
+	size_t GetCountOffset(size_t group)
+	{
+		return StateHeaderSize + group * sizeof(uint32_t);
+	}
+}
\ No newline at end of file
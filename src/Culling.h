@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Types.h"
+
+namespace Velkro::Culling
+{
+	// One object to cull, laid out like the std430 array the compute pass reads. Survivors are appended to their group's
+	// range of the indirect and draw data buffers, so each group can be drawn with one glMultiDrawElementsIndirectCount.
+	struct Candidate
+	{
+		float transform[16];
+		uint32_t material[4];
+
+		float sphere[4]; // Local bounding sphere, centre and radius.
+
+		uint32_t count, firstIndex;
+		int32_t baseVertex;
+		uint32_t group;
+
+		uint32_t groupFirst; // First command of the group in the output buffers.
+		uint32_t padding[3];
+	};
+
+	struct Culler;
+
+	// Visibility costs the CPU the same no matter how much is culled, frustum and occlusion tests run per object in a compute
+	// pass and the draw counts never come back. Occlusion tests use a depth pyramid built from the previous frame's depth,
+	// so objects moving out from behind an occluder can show up a frame late.
+	Culler* CreateCuller(size_t capacity, uint32_t indirectBuffer, uint32_t drawBuffer); // Both output buffers need room for capacity draws.
+	void DestroyCuller(Culler* culler); // Deferred to the context thread while the frame pipeline runs.
+
+	bool IsReady(Culler* culler); // False while the programs are still compiling.
+
+	// Records the culling pass, the counts it writes are read from GetCountBuffer at GetCountOffset(group).
+	void Cull(Culler* culler, const Candidate* candidates, size_t candidateCount, size_t groupCount, const float* viewProjection, bool occlusion);
+
+	// Records a copy of the depth drawn so far into the pyramid the next frame's occlusion tests read.
+	void BuildDepthPyramid(Culler* culler);
+
+	uint32_t GetCountBuffer(Culler* culler);
+	size_t GetCountOffset(size_t group);
+}
\ No newline at end of file
@@ -97,6 +97,13 @@ namespace Velkro
 			component->OnUpdate();
 		}
 	}
+	void Entity::OnFixedUpdate()
+	{
+		for (Component* component : m_Data->GetComponentsIndex())
+		{
+			component->OnFixedUpdate();
+		}
+	}
 	void Entity::OnExit()
 	{
 		for (Component* component : m_Data->GetComponentsIndex())
@@ -31,6 +31,7 @@ namespace Velkro
 		void AddComponent(Component* component);
 
 		void OnUpdate();
+		void OnFixedUpdate();
 		void OnEvent(Event* event, WindowComponent* windowComponent);
 		void OnExit();
 
@@ -0,0 +1,310 @@
+#include "FileWatcher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "Log.h"
+
+namespace Velkro::FileWatcher
+{
+	struct WatchedFile
+	{
+		std::string path; // As passed to Watch.
+		int references = 0;
+
+		std::filesystem::file_time_type lastWriteTime;
+	};
+
+	static std::mutex WatchMutex;
+	static std::unordered_map<std::string, WatchedFile> Files; // Keyed by absolute path.
+	static std::vector<std::string> Changes;
+
+	static std::thread WatchThread;
+	static std::atomic<bool> Running = false;
+
+	static double PollInterval = 0.25;
+
+#ifdef __linux__
+	static int Inotify = -1;
+	static std::unordered_map<std::string, int> Directories; // Directory to watch descriptor, with how many files use it.
+	static std::unordered_map<int, std::string> DirectoryPaths;
+	static std::unordered_map<std::string, int> DirectoryReferences;
+#endif
+
+	static std::string GetAbsolutePath(const std::string& filePath)
+	{
+		std::error_code error;
+
+		std::filesystem::path absolute = std::filesystem::absolute(filePath, error);
+
+		return (error ? std::filesystem::path(filePath) : absolute).lexically_normal().generic_string();
+	}
+
+	static std::filesystem::file_time_type GetLastWriteTime(const std::string& path)
+	{
+		std::error_code error;
+
+		std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+
+		return error ? std::filesystem::file_time_type() : time;
+	}
+
+	// Called with WatchMutex held.
+	static void AddChange(const std::string& absolutePath)
+	{
+		auto iterator = Files.find(absolutePath);
+
+		if (iterator == Files.end())
+		{
+			return;
+		}
+
+		if (std::find(Changes.begin(), Changes.end(), iterator->second.path) == Changes.end())
+		{
+			Changes.push_back(iterator->second.path);
+		}
+	}
+
+#ifdef __linux__
+	// Directories are watched instead of files, editors often save by writing a new file and renaming it over the old one.
+	static void WatchDirectory(const std::string& directory)
+	{
+		if (Inotify == -1 || DirectoryReferences[directory]++ > 0)
+		{
+			return;
+		}
+
+		int descriptor = inotify_add_watch(Inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+
+		if (descriptor == -1)
+		{
+			VLK_CORE_WARN("FileWatcher: Failed to watch directory \"{}\".", directory);
+
+			return;
+		}
+
+		Directories[directory] = descriptor;
+		DirectoryPaths[descriptor] = directory;
+	}
+
+	static void UnwatchDirectory(const std::string& directory)
+	{
+		if (Inotify == -1 || --DirectoryReferences[directory] > 0)
+		{
+			return;
+		}
+
+		DirectoryReferences.erase(directory);
+
+		auto iterator = Directories.find(directory);
+
+		if (iterator != Directories.end())
+		{
+			inotify_rm_watch(Inotify, iterator->second);
+
+			DirectoryPaths.erase(iterator->second);
+			Directories.erase(iterator);
+		}
+	}
+
+	static void ReadInotifyEvents()
+	{
+		alignas(inotify_event) char buffer[4096];
+
+		while (Running)
+		{
+			pollfd descriptor = { Inotify, POLLIN, 0 };
+
+			// Times out so Stop doesn't have to wait for a file to change.
+			if (poll(&descriptor, 1, 100) <= 0)
+			{
+				continue;
+			}
+
+			ssize_t length = read(Inotify, buffer, sizeof(buffer));
+
+			if (length <= 0)
+			{
+				continue;
+			}
+
+			std::lock_guard<std::mutex> lock(WatchMutex);
+
+			for (char* pointer = buffer; pointer < buffer + length;)
+			{
+				inotify_event* event = reinterpret_cast<inotify_event*>(pointer);
+
+				auto directory = DirectoryPaths.find(event->wd);
+
+				if (directory != DirectoryPaths.end() && event->len > 0)
+				{
+					AddChange(directory->second + '/' + event->name);
+				}
+
+				pointer += sizeof(inotify_event) + event->len;
+			}
+		}
+	}
+#endif
+
+	static void PollFiles()
+	{
+		while (Running)
+		{
+			std::this_thread::sleep_for(std::chrono::duration<double>(PollInterval));
+
+			std::lock_guard<std::mutex> lock(WatchMutex);
+
+			for (auto& [absolutePath, file] : Files)
+			{
+				std::filesystem::file_time_type time = GetLastWriteTime(absolutePath);
+
+				if (time != file.lastWriteTime)
+				{
+					file.lastWriteTime = time;
+
+					AddChange(absolutePath);
+				}
+			}
+		}
+	}
+
+	bool Start()
+	{
+		if (Running)
+		{
+			return true;
+		}
+
+		Running = true;
+
+#ifdef __linux__
+		Inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+		if (Inotify != -1)
+		{
+			std::lock_guard<std::mutex> lock(WatchMutex);
+
+			for (auto& [absolutePath, file] : Files)
+			{
+				for (int i = 0; i < file.references; i++)
+				{
+					WatchDirectory(std::filesystem::path(absolutePath).parent_path().generic_string());
+				}
+			}
+
+			WatchThread = std::thread(ReadInotifyEvents);
+
+			return true;
+		}
+
+		VLK_CORE_WARN("FileWatcher: inotify isn't available, polling files every {} seconds instead.", PollInterval);
+#endif
+
+		WatchThread = std::thread(PollFiles);
+
+		return true;
+	}
+
+	void Stop()
+	{
+		if (!Running)
+		{
+			return;
+		}
+
+		Running = false;
+
+		WatchThread.join();
+
+#ifdef __linux__
+		if (Inotify != -1)
+		{
+			close(Inotify);
+
+			Inotify = -1;
+
+			Directories.clear();
+			DirectoryPaths.clear();
+			DirectoryReferences.clear();
+		}
+#endif
+
+		std::lock_guard<std::mutex> lock(WatchMutex);
+
+		Changes.clear();
+	}
+
+	bool IsRunning()
+	{
+		return Running;
+	}
+
+	void Watch(const std::string& filePath)
+	{
+		std::string absolutePath = GetAbsolutePath(filePath);
+
+		std::lock_guard<std::mutex> lock(WatchMutex);
+
+		WatchedFile& file = Files[absolutePath];
+
+		if (file.references++ == 0)
+		{
+			file.path = filePath;
+			file.lastWriteTime = GetLastWriteTime(absolutePath);
+		}
+
+#ifdef __linux__
+		WatchDirectory(std::filesystem::path(absolutePath).parent_path().generic_string());
+#endif
+	}
+
+	void Unwatch(const std::string& filePath)
+	{
+		std::string absolutePath = GetAbsolutePath(filePath);
+
+		std::lock_guard<std::mutex> lock(WatchMutex);
+
+		auto iterator = Files.find(absolutePath);
+
+		if (iterator == Files.end())
+		{
+			return;
+		}
+
+#ifdef __linux__
+		UnwatchDirectory(std::filesystem::path(absolutePath).parent_path().generic_string());
+#endif
+
+		if (--iterator->second.references == 0)
+		{
+			Files.erase(iterator);
+		}
+	}
+
+	std::vector<std::string> PollChanges()
+	{
+		std::lock_guard<std::mutex> lock(WatchMutex);
+
+		std::vector<std::string> changes;
+		changes.swap(Changes);
+
+		return changes;
+	}
+
+	void SetPollInterval(double seconds)
+	{
+		PollInterval = seconds;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Types.h"
+
+// Watches files for changes on a background thread, using inotify on Linux and polling modification times elsewhere
+// or when inotify isn't available. Changes are collected until PollChanges is called.
+namespace Velkro::FileWatcher
+{
+	bool Start();
+	void Stop();
+
+	bool IsRunning();
+
+	void Watch(const std::string& filePath);
+	void Unwatch(const std::string& filePath);
+
+	std::vector<std::string> PollChanges(); // Paths as passed to Watch, each reported once per batch of changes.
+
+	void SetPollInterval(double seconds); // Only used by the polling fallback, defaults to 0.25 seconds.
+}
\ No newline at end of file
@@ -0,0 +1,378 @@
+#include "Font.h"
+
+#include <glad/glad.h>
+#include <stb_truetype.h>
+
+#include <algorithm>
+#include <format>
+#include <unordered_map>
+
+#include "Assets.h"
+#include "CommandBuffer.h"
+#include "FramePipeline.h"
+#include "IO.h"
+#include "Log.h"
+
+namespace Velkro
+{
+	static constexpr int GlyphPadding = 6; // Pixels of distance field around every glyph, also how far outlines and glows can reach.
+	static constexpr int GlyphGap = 1;
+
+	class Font::Data
+	{
+	public:
+		IO::FileView file;
+		stbtt_fontinfo info;
+
+		bool loaded = false;
+
+		float rasterSize;
+		float scale;
+		float lineHeight;
+
+		std::unordered_map<int, Glyph> glyphs;
+		std::unordered_map<int, bool> missingGlyphs;
+
+		Assets::Texture2DAsset* page = nullptr;
+		int pageSize;
+
+		// Shelf packing, glyphs fill a row left to right and a new row starts above the tallest one.
+		int shelfX = GlyphGap, shelfY = GlyphGap, shelfHeight = 0;
+
+		bool pageFull = false;
+	};
+
+	Font::Font(const char* fontPath, float rasterSize, int pageSize)
+	{
+		m_Data = new Data();
+		m_Data->rasterSize = rasterSize;
+		m_Data->pageSize = pageSize;
+
+		if (FramePipeline::IsRunning())
+		{
+			VLK_CORE_ERROR("Font \"{}\" created while the frame pipeline owns the GL context, create it before the pipeline starts.", fontPath);
+
+			return;
+		}
+
+		m_Data->file = IO::MapFile(fontPath);
+
+		const uint8_t* data = m_Data->file.GetPointer();
+
+		if (!m_Data->file.IsOpen() || !stbtt_InitFont(&m_Data->info, data, stbtt_GetFontOffsetForIndex(data, 0)))
+		{
+			VLK_CORE_ERROR("Failed to load font \"{}\".", fontPath);
+
+			return;
+		}
+
+		m_Data->scale = stbtt_ScaleForPixelHeight(&m_Data->info, rasterSize);
+
+		int ascent, descent, lineGap;
+		stbtt_GetFontVMetrics(&m_Data->info, &ascent, &descent, &lineGap);
+
+		m_Data->lineHeight = (ascent - descent + lineGap) * m_Data->scale;
+
+		uint32_t textureID;
+
+		glCreateTextures(GL_TEXTURE_2D, 1, &textureID);
+		glTextureStorage2D(textureID, 1, GL_RGBA8, pageSize, pageSize);
+		glTextureParameteri(textureID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTextureParameteri(textureID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		const uint8_t clear[4] = { 255, 255, 255, 0 };
+		glClearTexImage(textureID, 0, GL_RGBA, GL_UNSIGNED_BYTE, clear);
+
+		static int FontCount = 0;
+
+		m_Data->page = Assets::AddTexture2D(std::format("font{}/{}", FontCount++, fontPath), textureID, pageSize, pageSize, 4);
+
+		m_Data->loaded = true;
+	}
+
+	Font::~Font()
+	{
+		Assets::Release(m_Data->page);
+
+		delete m_Data;
+	}
+
+	bool Font::IsLoaded() const
+	{
+		return m_Data->loaded;
+	}
+
+	const Font::Glyph* Font::GetGlyph(int codepoint)
+	{
+		auto iterator = m_Data->glyphs.find(codepoint);
+
+		if (iterator != m_Data->glyphs.end())
+		{
+			return &iterator->second;
+		}
+
+		if (!m_Data->loaded || m_Data->missingGlyphs.contains(codepoint))
+		{
+			return nullptr;
+		}
+
+		int advance, leftSideBearing;
+		stbtt_GetCodepointHMetrics(&m_Data->info, codepoint, &advance, &leftSideBearing);
+
+		Glyph glyph = {};
+		glyph.advance = advance * m_Data->scale;
+
+		int width = 0, height = 0, xOffset = 0, yOffset = 0;
+
+		uint8_t* distances = stbtt_GetCodepointSDF(&m_Data->info, m_Data->scale, codepoint, GlyphPadding, 128, 128.0f / GlyphPadding, &width, &height, &xOffset, &yOffset);
+
+		// Whitespace has no outline but still advances the pen.
+		if (!distances)
+		{
+			if (!stbtt_FindGlyphIndex(&m_Data->info, codepoint))
+			{
+				m_Data->missingGlyphs[codepoint] = true;
+
+				return nullptr;
+			}
+
+			return &(m_Data->glyphs[codepoint] = glyph);
+		}
+
+		int pageSize = m_Data->pageSize;
+
+		if (m_Data->shelfX + width + GlyphGap > pageSize)
+		{
+			m_Data->shelfX = GlyphGap;
+			m_Data->shelfY += m_Data->shelfHeight + GlyphGap;
+			m_Data->shelfHeight = 0;
+		}
+
+		if (m_Data->shelfY + height + GlyphGap > pageSize)
+		{
+			if (!m_Data->pageFull)
+			{
+				VLK_CORE_ERROR("Font page is full, glyphs from now on are skipped. Use a bigger page or a smaller raster size.");
+
+				m_Data->pageFull = true;
+			}
+
+			stbtt_FreeSDF(distances, nullptr);
+
+			return nullptr;
+		}
+
+		int x = m_Data->shelfX;
+		int y = m_Data->shelfY;
+
+		m_Data->shelfX += width + GlyphGap;
+		m_Data->shelfHeight = std::max(m_Data->shelfHeight, height);
+
+		// Flipped so the glyph's bottom row is at the lowest v, like every other texture.
+		std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+
+		for (int row = 0; row < height; row++)
+		{
+			const uint8_t* source = distances + static_cast<size_t>(height - 1 - row) * width;
+			uint8_t* destination = pixels.data() + static_cast<size_t>(row) * width * 4;
+
+			for (int column = 0; column < width; column++)
+			{
+				destination[column * 4 + 0] = 255;
+				destination[column * 4 + 1] = 255;
+				destination[column * 4 + 2] = 255;
+				destination[column * 4 + 3] = source[column];
+			}
+		}
+
+		stbtt_FreeSDF(distances, nullptr);
+
+		CommandBuffer::Get().UploadTexture(m_Data->page->ID, x, y, width, height, pixels.data());
+
+		glyph.uMin = static_cast<float>(x) / pageSize;
+		glyph.vMin = static_cast<float>(y) / pageSize;
+		glyph.uMax = static_cast<float>(x + width) / pageSize;
+		glyph.vMax = static_cast<float>(y + height) / pageSize;
+
+		glyph.left = static_cast<float>(xOffset);
+		glyph.top = static_cast<float>(-yOffset);
+		glyph.width = static_cast<float>(width);
+		glyph.height = static_cast<float>(height);
+
+		return &(m_Data->glyphs[codepoint] = glyph);
+	}
+
+	float Font::GetKerning(int first, int second) const
+	{
+		return m_Data->loaded ? stbtt_GetCodepointKernAdvance(&m_Data->info, first, second) * m_Data->scale : 0.0f;
+	}
+
+	float Font::GetLineHeight() const
+	{
+		return m_Data->lineHeight;
+	}
+
+	float Font::GetRasterSize() const
+	{
+		return m_Data->rasterSize;
+	}
+
+	void Font::LayoutText(std::string_view text, float size, std::vector<GlyphQuad>& quads)
+	{
+		quads.clear();
+
+		float scale = size / m_Data->rasterSize;
+
+		float penX = 0.0f;
+		float penY = 0.0f;
+
+		int previous = 0;
+
+		for (size_t offset = 0; offset < text.size();)
+		{
+			int codepoint = DecodeUTF8(text, offset);
+
+			if (codepoint == '\n')
+			{
+				penX = 0.0f;
+				penY -= m_Data->lineHeight * scale;
+
+				previous = 0;
+
+				continue;
+			}
+
+			const Glyph* glyph = GetGlyph(codepoint);
+
+			if (!glyph)
+			{
+				previous = 0;
+
+				continue;
+			}
+
+			if (previous)
+			{
+				penX += GetKerning(previous, codepoint) * scale;
+			}
+
+			if (glyph->width > 0.0f)
+			{
+				GlyphQuad& quad = quads.emplace_back();
+				quad.left = penX + glyph->left * scale;
+				quad.top = penY + glyph->top * scale;
+				quad.right = quad.left + glyph->width * scale;
+				quad.bottom = quad.top - glyph->height * scale;
+				quad.uMin = glyph->uMin;
+				quad.vMin = glyph->vMin;
+				quad.uMax = glyph->uMax;
+				quad.vMax = glyph->vMax;
+			}
+
+			penX += glyph->advance * scale;
+
+			previous = codepoint;
+		}
+	}
+
+	float Font::MeasureText(std::string_view text, float size)
+	{
+		float scale = size / m_Data->rasterSize;
+
+		float width = 0.0f;
+		float lineWidth = 0.0f;
+
+		int previous = 0;
+
+		for (size_t offset = 0; offset < text.size();)
+		{
+			int codepoint = DecodeUTF8(text, offset);
+
+			if (codepoint == '\n')
+			{
+				lineWidth = 0.0f;
+				previous = 0;
+
+				continue;
+			}
+
+			const Glyph* glyph = GetGlyph(codepoint);
+
+			if (!glyph)
+			{
+				previous = 0;
+
+				continue;
+			}
+
+			if (previous)
+			{
+				lineWidth += GetKerning(previous, codepoint) * scale;
+			}
+
+			lineWidth += glyph->advance * scale;
+
+			width = std::max(width, lineWidth);
+
+			previous = codepoint;
+		}
+
+		return width;
+	}
+
+	Assets::Texture2DAsset* Font::GetPage() const
+	{
+		return m_Data->page;
+	}
+
+	int Font::DecodeUTF8(std::string_view text, size_t& offset)
+	{
+		uint8_t lead = static_cast<uint8_t>(text[offset++]);
+
+		if (lead < 0x80)
+		{
+			return lead;
+		}
+
+		// Stray continuation bytes and leads of five byte and longer sequences.
+		if (lead < 0xC0 || lead >= 0xF8)
+		{
+			return 0xFFFD;
+		}
+
+		int length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : 2;
+
+		if (offset + length - 1 > text.size())
+		{
+			return 0xFFFD;
+		}
+
+		int codepoint = lead & (0x7F >> length);
+
+		for (int i = 1; i < length; i++)
+		{
+			uint8_t continuation = static_cast<uint8_t>(text[offset]);
+
+			if ((continuation & 0xC0) != 0x80)
+			{
+				return 0xFFFD;
+			}
+
+			codepoint = (codepoint << 6) | (continuation & 0x3F);
+
+			offset++;
+		}
+
+		// Overlong encodings, UTF-16 surrogates and anything past U+10FFFF aren't characters.
+		static constexpr int ShortestCodepoint[5] = { 0, 0, 0x80, 0x800, 0x10000 };
+
+		if (codepoint < ShortestCodepoint[length] || (codepoint >= 0xD800 && codepoint <= 0xDFFF) || codepoint > 0x10FFFF)
+		{
+			return 0xFFFD;
+		}
+
+		return codepoint;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+#include "Types.h"
+
+namespace Velkro
+{
+	namespace Assets
+	{
+		struct Texture2DAsset;
+	}
+
+	// Signed distance field glyphs of one font, rasterized once at a fixed size into a shared atlas page the first time
+	// they are used. Because the page holds distances rather than coverage, text can be drawn at any size from it.
+	// The distance is in the alpha channel, 0.5 being the glyph's edge, so a fragment shader would do something like
+	// alpha = smoothstep(0.5 - fwidth(d), 0.5 + fwidth(d), d).
+	class Font
+	{
+	public:
+		struct Glyph
+		{
+			float uMin, vMin, uMax, vMax;
+			float left, top, width, height; // Quad relative to the pen on the baseline, y up, in raster pixels.
+			float advance;
+		};
+
+		struct GlyphQuad
+		{
+			float left, bottom, right, top;
+			float uMin, vMin, uMax, vMax;
+		};
+
+		Font(const char* fontPath, float rasterSize = 48.0f, int pageSize = 1024);
+		~Font();
+
+		bool IsLoaded() const;
+
+		const Glyph* GetGlyph(int codepoint); // Rasterizes the glyph on first use, nullptr if it has no outline or the page is full.
+		float GetKerning(int first, int second) const; // In raster pixels.
+
+		float GetLineHeight() const;
+		float GetRasterSize() const;
+
+		// Positions every glyph of a UTF-8 string with kerning, the first baseline at y = 0, newlines moving down one line.
+		void LayoutText(std::string_view text, float size, std::vector<GlyphQuad>& quads);
+		float MeasureText(std::string_view text, float size); // Width of the widest line.
+
+		Assets::Texture2DAsset* GetPage() const;
+
+		static int DecodeUTF8(std::string_view text, size_t& offset); // Returns the codepoint at offset and moves past it, 0xFFFD for invalid bytes.
+
+	private:
+		class Data;
+		Data* m_Data;
+	};
+}
\ No newline at end of file
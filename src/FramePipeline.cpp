@@ -0,0 +1,163 @@
+#include "FramePipeline.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "CommandBuffer.h"
+#include "Window.h"
+#include "Log.h"
+
+namespace Velkro
+{
+	namespace FramePipeline
+	{
+		// One frame being collected, one waiting for the render thread and one being executed.
+		static CommandBuffer Frames[3];
+
+		static int RecordingIndex = 0;
+		static int PendingIndex = -1;
+		static int ExecutingIndex = -1;
+
+		static bool Running = false;
+		static bool Stopping = false;
+
+		static std::thread RenderThread;
+		static std::mutex Mutex;
+		static std::condition_variable Condition;
+
+		static GLFWwindow* Context = nullptr;
+
+		static void RenderLoop()
+		{
+			Window::MakeContextCurrent(Context);
+
+			while (true)
+			{
+				std::unique_lock<std::mutex> lock(Mutex);
+
+				Condition.wait(lock, [] { return PendingIndex != -1 || Stopping; });
+
+				if (PendingIndex == -1)
+				{
+					break;
+				}
+
+				ExecutingIndex = PendingIndex;
+				PendingIndex = -1;
+
+				lock.unlock();
+
+				Condition.notify_all();
+
+				Frames[ExecutingIndex].Execute();
+
+				Frames[ExecutingIndex].Reset();
+
+				lock.lock();
+
+				ExecutingIndex = -1;
+
+				lock.unlock();
+
+				Condition.notify_all();
+			}
+
+			Window::MakeContextCurrent(nullptr);
+		}
+
+		void Start()
+		{
+			if (Running)
+			{
+				return;
+			}
+
+			Context = Window::GetCurrentContext();
+
+			if (!Context)
+			{
+				VLK_CORE_ERROR("Frame pipeline needs a window before it can start.");
+
+				return;
+			}
+
+			Window::MakeContextCurrent(nullptr);
+
+			RecordingIndex = 0;
+			PendingIndex = -1;
+			ExecutingIndex = -1;
+
+			Stopping = false;
+			Running = true;
+
+			RenderThread = std::thread(RenderLoop);
+
+			VLK_CORE_DEBUG("Frame pipeline started.");
+		}
+
+		void Stop()
+		{
+			if (!Running)
+			{
+				return;
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+
+				Stopping = true;
+			}
+
+			Condition.notify_all();
+
+			RenderThread.join();
+
+			Running = false;
+
+			Window::MakeContextCurrent(Context);
+
+			VLK_CORE_DEBUG("Frame pipeline stopped.");
+		}
+
+		bool IsRunning()
+		{
+			return Running;
+		}
+
+		void Submit()
+		{
+			if (!Running)
+			{
+				CommandBuffer::Collect(Frames[RecordingIndex]);
+
+				Frames[RecordingIndex].Execute();
+				Frames[RecordingIndex].Reset();
+
+				return;
+			}
+
+			CommandBuffer::Collect(Frames[RecordingIndex]);
+
+			std::unique_lock<std::mutex> lock(Mutex);
+
+			Condition.wait(lock, [] { return PendingIndex == -1; });
+
+			PendingIndex = RecordingIndex;
+
+			for (int i = 0; i < 3; i++)
+			{
+				if (i != PendingIndex && i != ExecutingIndex)
+				{
+					RecordingIndex = i;
+
+					break;
+				}
+			}
+
+			lock.unlock();
+
+			Condition.notify_all();
+		}
+	}
+}
\ No newline at end of file
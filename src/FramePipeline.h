@@ -0,0 +1,15 @@
+#pragma once
+
+namespace Velkro
+{
+	// Runs GL submission on its own thread one frame behind the simulation, the render thread owns the GL context while running.
+	namespace FramePipeline
+	{
+		void Start();
+		void Stop();
+
+		bool IsRunning();
+
+		void Submit(); // Collects the frame's command buffers and executes them, or hands them to the render thread when running, waiting if it is more than a frame behind.
+	}
+}
\ No newline at end of file
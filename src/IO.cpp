@@ -1,27 +1,314 @@
 #include "IO.h"
 
+#include <cstdio>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace Velkro::IO
 {
-	std::string GetFile(std::string filePath)
+	// Reads the whole file into data with a single read, sized from the file itself.
+	template<typename Container>
+	static bool ReadFile(const std::string& filePath, Container& data)
+	{
+		FILE* file = std::fopen(filePath.c_str(), "rb");
+
+		if (!file)
+		{
+			return false;
+		}
+
+		std::fseek(file, 0, SEEK_END);
+		long size = std::ftell(file);
+		std::fseek(file, 0, SEEK_SET);
+
+		if (size < 0)
+		{
+			std::fclose(file);
+
+			return false;
+		}
+
+		data.resize(static_cast<size_t>(size));
+
+		bool success = std::fread(data.data(), 1, data.size(), file) == data.size();
+
+		std::fclose(file);
+
+		return success;
+	}
+
+	FileView::FileView(const std::string& filePath)
+	{
+		if (!OpenFromArchives(filePath, *this))
+		{
+			m_OpenLoose(filePath);
+		}
+	}
+
+	void FileView::m_OpenLoose(const std::string& filePath)
+	{
+#ifdef _WIN32
+		HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return;
+		}
+
+		LARGE_INTEGER fileSize;
+		GetFileSizeEx(file, &fileSize);
+
+		m_Size = static_cast<size_t>(fileSize.QuadPart);
+
+		if (m_Size >= MapThreshold)
+		{
+			m_MappingHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+			if (m_MappingHandle)
+			{
+				m_Mapping = MapViewOfFile(m_MappingHandle, FILE_MAP_READ, 0, 0, 0);
+			}
+		}
+
+		CloseHandle(file);
+#else
+		int file = open(filePath.c_str(), O_RDONLY);
+
+		if (file == -1)
+		{
+			return;
+		}
+
+		struct stat status;
+
+		if (fstat(file, &status) != 0)
+		{
+			close(file);
+
+			return;
+		}
+
+		m_Size = static_cast<size_t>(status.st_size);
+
+		if (m_Size >= MapThreshold)
+		{
+			void* mapping = mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, file, 0);
+
+			if (mapping != MAP_FAILED)
+			{
+				m_Mapping = mapping;
+			}
+		}
+
+		close(file);
+#endif
+
+		if (m_Mapping)
+		{
+			m_Pointer = static_cast<const uint8_t*>(m_Mapping);
+			m_Open = true;
+
+			return;
+		}
+
+		// Small files, or mapping failed.
+		if (ReadFile(filePath, m_Buffer))
+		{
+			m_Size = m_Buffer.size();
+			m_Pointer = m_Buffer.data();
+			m_Open = true;
+		}
+		else
+		{
+			m_Size = 0;
+		}
+	}
+
+	FileView::~FileView()
 	{
-		std::ifstream file(filePath);
+		m_Release();
+	}
 
-		if (!file.is_open())
+	FileView::FileView(FileView&& other) noexcept
+	{
+		*this = std::move(other);
+	}
+
+	FileView& FileView::operator=(FileView&& other) noexcept
+	{
+		if (this != &other)
+		{
+			m_Release();
+
+			m_Buffer = std::move(other.m_Buffer);
+
+			m_Size = other.m_Size;
+			m_Open = other.m_Open;
+			m_Mapping = other.m_Mapping;
+			m_MappingHandle = other.m_MappingHandle;
+			m_Owner = std::move(other.m_Owner);
+			m_Pointer = m_Mapping || m_Owner ? other.m_Pointer : m_Buffer.data();
+
+			other.m_Pointer = nullptr;
+			other.m_Size = 0;
+			other.m_Open = false;
+			other.m_Mapping = nullptr;
+			other.m_MappingHandle = nullptr;
+		}
+
+		return *this;
+	}
+
+	void FileView::m_Release()
+	{
+		if (m_Mapping)
+		{
+#ifdef _WIN32
+			UnmapViewOfFile(m_Mapping);
+#else
+			munmap(m_Mapping, m_Size);
+#endif
+		}
+
+#ifdef _WIN32
+		if (m_MappingHandle)
+		{
+			CloseHandle(m_MappingHandle);
+		}
+#endif
+
+		m_Buffer.clear();
+		m_Buffer.shrink_to_fit();
+
+		m_Owner.reset();
+
+		m_Pointer = nullptr;
+		m_Size = 0;
+		m_Open = false;
+		m_Mapping = nullptr;
+		m_MappingHandle = nullptr;
+	}
+
+	bool FileView::IsOpen() const
+	{
+		return m_Open;
+	}
+
+	bool FileView::IsMapped() const
+	{
+		return m_Mapping != nullptr;
+	}
+
+	std::span<const uint8_t> FileView::GetData() const
+	{
+		return std::span<const uint8_t>(m_Pointer, m_Size);
+	}
+
+	const uint8_t* FileView::GetPointer() const
+	{
+		return m_Pointer;
+	}
+
+	size_t FileView::GetSize() const
+	{
+		return m_Size;
+	}
+
+	void FileView::Close()
+	{
+		m_Release();
+	}
+
+	FileView FileView::OpenLoose(const std::string& filePath)
+	{
+		FileView view;
+		view.m_OpenLoose(filePath);
+
+		return view;
+	}
+
+	FileView FileView::FromBuffer(std::vector<uint8_t>&& buffer)
+	{
+		FileView view;
+		view.m_Buffer = std::move(buffer);
+		view.m_Pointer = view.m_Buffer.data();
+		view.m_Size = view.m_Buffer.size();
+		view.m_Open = true;
+
+		return view;
+	}
+
+	FileView FileView::FromShared(const uint8_t* pointer, size_t size, std::shared_ptr<const void> owner)
+	{
+		FileView view;
+		view.m_Owner = std::move(owner);
+		view.m_Pointer = pointer;
+		view.m_Size = size;
+		view.m_Open = true;
+
+		return view;
+	}
+
+	FileView MapFile(const std::string& filePath)
+	{
+		FileView view(filePath);
+
+		if (!view.IsOpen())
 		{
 			VLK_CORE_ERROR("IO: Failed to open file {0}", filePath);
 		}
 
-		std::string fileStr;
+		return view;
+	}
+
+	std::string GetFile(std::string filePath)
+	{
+		FileView archived;
 
-		std::string line;
-		while (std::getline(file, line))
+		if (OpenFromArchives(filePath, archived))
 		{
-			fileStr += line + '\n';
+			return std::string(reinterpret_cast<const char*>(archived.GetPointer()), archived.GetSize());
 		}
 
-		// Close the file
-		file.close();
+		std::string fileStr;
+
+		if (!ReadFile(filePath, fileStr))
+		{
+			VLK_CORE_ERROR("IO: Failed to open file {0}", filePath);
+
+			return {};
+		}
 
 		return fileStr;
 	}
+
+	std::vector<uint8_t> GetBinaryFile(std::string filePath)
+	{
+		FileView archived;
+
+		if (OpenFromArchives(filePath, archived))
+		{
+			return std::vector<uint8_t>(archived.GetPointer(), archived.GetPointer() + archived.GetSize());
+		}
+
+		std::vector<uint8_t> bytes;
+
+		if (!ReadFile(filePath, bytes))
+		{
+			VLK_CORE_ERROR("IO: Failed to open file {0}", filePath);
+
+			return {};
+		}
+
+		return bytes;
+	}
 }
\ No newline at end of file
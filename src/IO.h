@@ -3,10 +3,76 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <vector>
+#include <span>
+#include <cstdint>
+#include <memory>
 
 #include "Log.h"
 
 namespace Velkro::IO
 {
+	// Read-only view of a whole file, resolved through the mounted archives first. Small files are read into memory with a single read,
+	// larger ones are memory mapped so only the pages that are touched get loaded. The view owns its memory and is move only.
+	class FileView
+	{
+	public:
+		FileView() = default;
+		FileView(const std::string& filePath);
+		~FileView();
+
+		FileView(const FileView&) = delete;
+		FileView& operator=(const FileView&) = delete;
+
+		FileView(FileView&& other) noexcept;
+		FileView& operator=(FileView&& other) noexcept;
+
+		bool IsOpen() const;
+		bool IsMapped() const;
+
+		std::span<const uint8_t> GetData() const;
+
+		const uint8_t* GetPointer() const;
+		size_t GetSize() const;
+
+		void Close();
+
+		static FileView OpenLoose(const std::string& filePath); // Skips the mounted archives.
+		static FileView FromBuffer(std::vector<uint8_t>&& buffer);
+		static FileView FromShared(const uint8_t* pointer, size_t size, std::shared_ptr<const void> owner); // Memory kept alive by owner.
+
+		static inline size_t MapThreshold = 64 * 1024; // Files at least this big are mapped instead of read.
+
+	private:
+		void m_Release();
+		void m_OpenLoose(const std::string& filePath);
+
+		const uint8_t* m_Pointer = nullptr;
+		size_t m_Size = 0;
+
+		bool m_Open = false;
+
+		std::vector<uint8_t> m_Buffer; // Holds small files.
+
+		void* m_Mapping = nullptr;
+		void* m_MappingHandle = nullptr; // Only used on Windows.
+
+		std::shared_ptr<const void> m_Owner; // Archive the view points into.
+	};
+
+	FileView MapFile(const std::string& filePath); // Logs an error and returns a closed view on failure.
+
+	// Mounted .vpak archives are searched newest first, one mapped file serves every entry in it.
+	bool Mount(const std::string& archivePath);
+	void Unmount(const std::string& archivePath);
+
+	void SetLooseFileOverrides(bool enabled); // Loose files on disk win over archive entries, on by default in debug builds.
+
+	bool Exists(const std::string& filePath);
+
+	bool OpenFromArchives(const std::string& filePath, FileView& view); // Returns false if the path isn't archived or a loose file overrides it.
+
+	// Exact size single reads, binary safe. Both return empty on failure.
 	std::string GetFile(std::string filePath);
+	std::vector<uint8_t> GetBinaryFile(std::string filePath);
 }
\ No newline at end of file
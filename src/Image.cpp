@@ -0,0 +1,350 @@
+#include "Image.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+#include "Cooked.h"
+#include "Log.h"
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
+#ifndef GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT 0x8C4F
+#endif
+
+namespace Velkro::Image
+{
+	struct DDSPixelFormat
+	{
+		uint32_t size, flags, fourCC, bitCount;
+		uint32_t redMask, greenMask, blueMask, alphaMask;
+	};
+
+	struct DDSHeader
+	{
+		uint32_t size, flags, height, width, pitchOrLinearSize, depth, mipMapCount;
+		uint32_t reserved[11];
+		DDSPixelFormat pixelFormat;
+		uint32_t caps, caps2, caps3, caps4, reserved2;
+	};
+
+	struct DDSHeaderDX10
+	{
+		uint32_t dxgiFormat, resourceDimension, miscFlag, arraySize, miscFlags2;
+	};
+
+	static constexpr uint32_t FourCC(const char code[5])
+	{
+		return uint32_t(code[0]) | (uint32_t(code[1]) << 8) | (uint32_t(code[2]) << 16) | (uint32_t(code[3]) << 24);
+	}
+
+	static constexpr uint32_t DDPFFourCC = 0x4;
+	static constexpr uint32_t DDPFRGB = 0x40;
+
+	// Fills in everything but the pixels, level offsets are from the start of data.
+	static bool ParseDDS(const uint8_t* data, size_t size, ImageData& image, size_t& dataEnd)
+	{
+		if (size < 4 + sizeof(DDSHeader) || std::memcmp(data, "DDS ", 4) != 0)
+		{
+			VLK_CORE_ERROR("Image: Not a DDS file.");
+
+			return false;
+		}
+
+		DDSHeader header;
+		std::memcpy(&header, data + 4, sizeof(DDSHeader));
+
+		size_t offset = 4 + sizeof(DDSHeader);
+
+		int blockSize = 0;
+
+		if (header.pixelFormat.flags & DDPFFourCC)
+		{
+			uint32_t fourCC = header.pixelFormat.fourCC;
+
+			if (fourCC == FourCC("DXT1"))
+			{
+				image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+				blockSize = 8;
+			}
+			else if (fourCC == FourCC("DXT5"))
+			{
+				image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+				blockSize = 16;
+			}
+			else if (fourCC == FourCC("DX10"))
+			{
+				if (size < offset + sizeof(DDSHeaderDX10))
+				{
+					VLK_CORE_ERROR("Image: DDS file is missing its DX10 header.");
+
+					return false;
+				}
+
+				DDSHeaderDX10 headerDX10;
+				std::memcpy(&headerDX10, data + offset, sizeof(DDSHeaderDX10));
+
+				offset += sizeof(DDSHeaderDX10);
+
+				switch (headerDX10.dxgiFormat)
+				{
+				case 28: image.internalFormat = GL_RGBA8; image.format = GL_RGBA; break;
+				case 29: image.internalFormat = GL_SRGB8_ALPHA8; image.format = GL_RGBA; break;
+				case 71: image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; blockSize = 8; break;
+				case 72: image.internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT; blockSize = 8; break;
+				case 77: image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; blockSize = 16; break;
+				case 78: image.internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT; blockSize = 16; break;
+				case 87: image.internalFormat = GL_RGBA8; image.format = GL_BGRA; break;
+				case 98: image.internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM; blockSize = 16; break;
+				case 99: image.internalFormat = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM; blockSize = 16; break;
+				default:
+					VLK_CORE_ERROR("Image: Unsupported DXGI format {} in DDS file.", headerDX10.dxgiFormat);
+
+					return false;
+				}
+			}
+			else
+			{
+				VLK_CORE_ERROR("Image: Unsupported DDS compression {:#x}.", fourCC);
+
+				return false;
+			}
+		}
+		else if ((header.pixelFormat.flags & DDPFRGB) && header.pixelFormat.bitCount == 32)
+		{
+			image.internalFormat = GL_RGBA8;
+			image.format = header.pixelFormat.redMask == 0x000000FF ? GL_RGBA : GL_BGRA;
+		}
+		else
+		{
+			VLK_CORE_ERROR("Image: Unsupported DDS pixel format.");
+
+			return false;
+		}
+
+		image.compressed = blockSize != 0;
+
+		if (image.compressed)
+		{
+			image.format = 0;
+		}
+
+		image.width = static_cast<int>(header.width);
+		image.height = static_cast<int>(header.height);
+
+		int levelCount = std::max(1u, header.mipMapCount);
+
+		image.levels.clear();
+
+		int width = image.width;
+		int height = image.height;
+
+		size_t dataSize = 0;
+
+		for (int i = 0; i < levelCount; i++)
+		{
+			size_t levelSize;
+
+			if (image.compressed)
+			{
+				levelSize = static_cast<size_t>(std::max(1, (width + 3) / 4)) * std::max(1, (height + 3) / 4) * blockSize;
+			}
+			else
+			{
+				levelSize = static_cast<size_t>(width) * height * 4;
+			}
+
+			if (offset + dataSize + levelSize > size)
+			{
+				VLK_CORE_WARN("Image: DDS file is truncated, keeping {} of {} mip levels.", i, levelCount);
+
+				break;
+			}
+
+			image.levels.push_back({ offset + dataSize, levelSize, width, height });
+
+			dataSize += levelSize;
+
+			width = std::max(1, width / 2);
+			height = std::max(1, height / 2);
+		}
+
+		if (image.levels.empty())
+		{
+			return false;
+		}
+
+		dataEnd = offset + dataSize;
+
+		return true;
+	}
+
+	bool LoadDDS(const uint8_t* data, size_t size, ImageData& image)
+	{
+		size_t dataEnd;
+
+		if (!ParseDDS(data, size, image, dataEnd))
+		{
+			return false;
+		}
+
+		image.pixels.assign(data, data + dataEnd);
+
+		return true;
+	}
+
+	bool LoadCookedTexture(IO::FileView&& file, ImageData& image)
+	{
+		std::span<const uint8_t> blob = file.GetData();
+
+		Cooked::TextureHeader header;
+
+		if (blob.size() < sizeof(header))
+		{
+			VLK_CORE_ERROR("Image: Cooked texture is truncated.");
+
+			return false;
+		}
+
+		std::memcpy(&header, blob.data(), sizeof(header));
+
+		if (header.magic != Cooked::TextureMagic)
+		{
+			VLK_CORE_ERROR("Image: Not a cooked texture.");
+
+			return false;
+		}
+
+		if (header.version != Cooked::Version)
+		{
+			VLK_CORE_ERROR("Image: Cooked texture has version {}, expected {}. Cook it again with VelkroCook.", header.version, Cooked::Version);
+
+			return false;
+		}
+
+		if (blob.size() < sizeof(header) + header.levelCount * sizeof(Cooked::TextureLevel))
+		{
+			VLK_CORE_ERROR("Image: Cooked texture is truncated.");
+
+			return false;
+		}
+
+		image.internalFormat = header.internalFormat;
+		image.format = header.format;
+		image.compressed = header.compressed != 0;
+		image.width = header.width;
+		image.height = header.height;
+		image.tileWidth = header.tileWidth;
+		image.tileHeight = header.tileHeight;
+
+		image.levels.clear();
+
+		for (uint32_t i = 0; i < header.levelCount; i++)
+		{
+			Cooked::TextureLevel level;
+			std::memcpy(&level, blob.data() + sizeof(header) + i * sizeof(level), sizeof(level));
+
+			if (level.offset + level.size > blob.size())
+			{
+				VLK_CORE_ERROR("Image: Cooked texture level {} is out of bounds.", i);
+
+				return false;
+			}
+
+			image.levels.push_back({ level.offset, level.size, level.width, level.height });
+		}
+
+		image.pixels.clear();
+		image.file = std::move(file);
+
+		return !image.levels.empty();
+	}
+
+	bool ReadCookedTileSize(const char* path, int& tileWidth, int& tileHeight)
+	{
+		// Through the VFS, so atlases packed into an archive keep their tile size.
+		IO::FileView file = IO::MapFile(path);
+
+		Cooked::TextureHeader header;
+
+		if (!file.IsOpen() || file.GetSize() < sizeof(header))
+		{
+			return false;
+		}
+
+		std::memcpy(&header, file.GetPointer(), sizeof(header));
+
+		if (header.magic != Cooked::TextureMagic || header.version != Cooked::Version)
+		{
+			return false;
+		}
+
+		tileWidth = header.tileWidth;
+		tileHeight = header.tileHeight;
+
+		return true;
+	}
+
+	bool IsDDS(const char* path)
+	{
+		std::string_view view(path);
+
+		return view.size() >= 4 && (view.ends_with(".dds") || view.ends_with(".DDS"));
+	}
+
+	bool IsCookedTexture(const char* path)
+	{
+		return std::string_view(path).ends_with(".vtex");
+	}
+
+	bool IsContainer(const char* path)
+	{
+		return IsDDS(path) || IsCookedTexture(path);
+	}
+
+	bool LoadContainer(const char* path, ImageData& image)
+	{
+		IO::FileView file = IO::MapFile(path);
+
+		if (!file.IsOpen())
+		{
+			return false;
+		}
+
+		if (IsCookedTexture(path))
+		{
+			return LoadCookedTexture(std::move(file), image);
+		}
+
+		size_t dataEnd;
+
+		if (!ParseDDS(file.GetPointer(), file.GetSize(), image, dataEnd))
+		{
+			return false;
+		}
+
+		image.pixels.clear();
+		image.file = std::move(file);
+
+		return true;
+	}
+
+	int GetMipLevelCount(int width, int height)
+	{
+		int levels = 1;
+
+		for (int size = std::max(width, height); size > 1; size /= 2)
+		{
+			levels++;
+		}
+
+		return levels;
+	}
+}
\ No newline at end of file
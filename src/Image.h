@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Types.h"
+#include "IO.h"
+
+namespace Velkro::Image
+{
+	// Pixel data ready to upload, either RGBA8 or block compressed, with one entry per mip level.
+	struct ImageData
+	{
+		struct Level
+		{
+			size_t offset, size;
+			int width, height;
+		};
+
+		uint32_t internalFormat = 0; // GL internal format.
+		uint32_t format = 0; // GL pixel format for uncompressed data, 0 when compressed.
+
+		bool compressed = false;
+
+		int width = 0, height = 0;
+
+		int tileWidth = 0, tileHeight = 0; // Atlas metadata from cooked textures.
+
+		std::vector<Level> levels; // Offsets are into GetPixels().
+
+		std::vector<uint8_t> pixels; // Owned pixels of decoded or converted images.
+		IO::FileView file; // Pixels read straight from a file view, used while pixels is empty.
+
+		const uint8_t* GetPixels() const
+		{
+			return pixels.empty() ? file.GetPointer() : pixels.data();
+		}
+	};
+
+	// Reads DDS files holding BC1, BC3, BC7 or 32 bit RGBA/BGRA data, including mip chains. Pixels are kept as stored,
+	// so DDS files need to be authored bottom row first to match images loaded through stb.
+	bool LoadDDS(const uint8_t* data, size_t size, ImageData& image);
+
+	// Takes over the view of a blob written by VelkroCook, level offsets point straight into it so nothing is decoded or copied.
+	bool LoadCookedTexture(IO::FileView&& file, ImageData& image);
+	bool ReadCookedTileSize(const char* path, int& tileWidth, int& tileHeight); // Only reads the header, through the VFS.
+
+	bool IsDDS(const char* path);
+	bool IsCookedTexture(const char* path);
+
+	// Maps DDS files and cooked textures without copying their pixels, anything else is left to stb.
+	bool IsContainer(const char* path);
+	bool LoadContainer(const char* path, ImageData& image);
+
+	int GetMipLevelCount(int width, int height);
+}
\ No newline at end of file
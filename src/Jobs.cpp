@@ -0,0 +1,153 @@
+#include "Jobs.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+#include "CommandBuffer.h"
+#include "Log.h"
+
+namespace Velkro
+{
+	JobHandle::JobHandle(std::shared_ptr<std::atomic<bool>> done)
+		: m_Done(std::move(done))
+	{
+	}
+
+	bool JobHandle::IsDone() const
+	{
+		return !m_Done || m_Done->load(std::memory_order_acquire);
+	}
+
+	void JobHandle::Wait() const
+	{
+		while (!IsDone())
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	bool JobHandle::IsValid() const
+	{
+		return m_Done != nullptr;
+	}
+
+	namespace Jobs
+	{
+		struct QueuedJob
+		{
+			std::function<void()> function;
+			std::shared_ptr<std::atomic<bool>> done;
+		};
+
+		static std::vector<std::thread> Threads;
+		static std::deque<QueuedJob> Queue;
+
+		static std::mutex Mutex;
+		static std::condition_variable Condition;
+
+		static bool Stopping = false;
+
+		static void WorkerLoop()
+		{
+			while (true)
+			{
+				QueuedJob job;
+
+				{
+					std::unique_lock<std::mutex> lock(Mutex);
+
+					Condition.wait(lock, [] { return !Queue.empty() || Stopping; });
+
+					if (Queue.empty())
+					{
+						break;
+					}
+
+					job = std::move(Queue.front());
+					Queue.pop_front();
+				}
+
+				job.function();
+
+				CommandBuffer::Flush();
+
+				job.done->store(true, std::memory_order_release);
+			}
+		}
+
+		void Initialize(int threadCount)
+		{
+			if (!Threads.empty())
+			{
+				return;
+			}
+
+			if (threadCount <= 0)
+			{
+				threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+			}
+
+			Stopping = false;
+
+			for (int i = 0; i < threadCount; i++)
+			{
+				Threads.emplace_back(WorkerLoop);
+			}
+
+			VLK_CORE_DEBUG("Started {} job threads.", threadCount);
+		}
+
+		void Shutdown()
+		{
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+
+				Stopping = true;
+			}
+
+			Condition.notify_all();
+
+			for (std::thread& thread : Threads)
+			{
+				thread.join();
+			}
+
+			Threads.clear();
+		}
+
+		JobHandle Submit(std::function<void()> job)
+		{
+			std::shared_ptr<std::atomic<bool>> done = std::make_shared<std::atomic<bool>>(false);
+
+			if (Threads.empty())
+			{
+				VLK_CORE_WARN("Job submitted before the job threads started, running it on the calling thread.");
+
+				job();
+
+				done->store(true);
+
+				return JobHandle(done);
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(Mutex);
+
+				Queue.push_back({ std::move(job), done });
+			}
+
+			Condition.notify_one();
+
+			return JobHandle(done);
+		}
+
+		int GetThreadCount()
+		{
+			return static_cast<int>(Threads.size());
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace Velkro
+{
+	class JobHandle
+	{
+	public:
+		JobHandle() = default;
+		JobHandle(std::shared_ptr<std::atomic<bool>> done);
+
+		bool IsDone() const;
+		void Wait() const;
+
+		bool IsValid() const;
+
+	private:
+		std::shared_ptr<std::atomic<bool>> m_Done;
+	};
+
+	// Worker threads for work that doesn't need the GL context, render commands recorded by a job are flushed when it finishes.
+	namespace Jobs
+	{
+		void Initialize(int threadCount = 0); // 0 uses one thread per core, minus the main thread.
+		void Shutdown();
+
+		JobHandle Submit(std::function<void()> job);
+
+		int GetThreadCount();
+	}
+}
\ No newline at end of file
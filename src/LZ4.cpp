@@ -0,0 +1,230 @@
+#include "LZ4.h"
+
+#include <cstring>
+
+namespace Velkro::LZ4
+{
+	static constexpr int HashBits = 16;
+	static constexpr size_t MinMatch = 4;
+	static constexpr size_t LastLiterals = 5; // The last 5 bytes are always literals.
+	static constexpr size_t MatchSafeDistance = 12; // A match can't start within the last 12 bytes.
+	static constexpr size_t MaxDistance = 65535;
+
+	static uint32_t Read32(const uint8_t* pointer)
+	{
+		uint32_t value;
+		std::memcpy(&value, pointer, sizeof(value));
+
+		return value;
+	}
+
+	static uint32_t Hash(uint32_t sequence)
+	{
+		return (sequence * 2654435761u) >> (32 - HashBits);
+	}
+
+	static void WriteLength(std::vector<uint8_t>& destination, size_t length)
+	{
+		while (length >= 255)
+		{
+			destination.push_back(255);
+			length -= 255;
+		}
+
+		destination.push_back(static_cast<uint8_t>(length));
+	}
+
+	static void WriteSequence(std::vector<uint8_t>& destination, const uint8_t* literals, size_t literalLength, size_t matchLength, size_t offset)
+	{
+		size_t token = destination.size();
+
+		destination.push_back(0);
+
+		uint8_t literalToken = literalLength >= 15 ? 15 : static_cast<uint8_t>(literalLength);
+
+		if (literalLength >= 15)
+		{
+			WriteLength(destination, literalLength - 15);
+		}
+
+		destination.insert(destination.end(), literals, literals + literalLength);
+
+		uint8_t matchToken = 0;
+
+		if (matchLength != 0)
+		{
+			destination.push_back(static_cast<uint8_t>(offset & 0xFF));
+			destination.push_back(static_cast<uint8_t>(offset >> 8));
+
+			size_t length = matchLength - MinMatch;
+
+			matchToken = length >= 15 ? 15 : static_cast<uint8_t>(length);
+
+			if (length >= 15)
+			{
+				WriteLength(destination, length - 15);
+			}
+		}
+
+		destination[token] = static_cast<uint8_t>((literalToken << 4) | matchToken);
+	}
+
+	size_t GetMaxCompressedSize(size_t size)
+	{
+		return size + size / 255 + 16;
+	}
+
+	size_t Compress(const uint8_t* source, size_t sourceSize, std::vector<uint8_t>& destination)
+	{
+		size_t start = destination.size();
+
+		destination.reserve(start + GetMaxCompressedSize(sourceSize));
+
+		size_t anchor = 0;
+
+		if (sourceSize > MatchSafeDistance)
+		{
+			std::vector<uint32_t> table(size_t(1) << HashBits, 0xFFFFFFFF);
+
+			size_t matchLimit = sourceSize - LastLiterals;
+			size_t position = 0;
+
+			while (position + MatchSafeDistance <= sourceSize)
+			{
+				uint32_t sequence = Read32(source + position);
+				uint32_t& entry = table[Hash(sequence)];
+
+				size_t candidate = entry;
+				entry = static_cast<uint32_t>(position);
+
+				if (candidate == 0xFFFFFFFF || position - candidate > MaxDistance || Read32(source + candidate) != sequence)
+				{
+					position++;
+
+					continue;
+				}
+
+				// Extend backwards over literals that also match.
+				while (position > anchor && candidate > 0 && source[position - 1] == source[candidate - 1])
+				{
+					position--;
+					candidate--;
+				}
+
+				size_t length = MinMatch;
+
+				while (position + length < matchLimit && source[position + length] == source[candidate + length])
+				{
+					length++;
+				}
+
+				WriteSequence(destination, source + anchor, position - anchor, length, position - candidate);
+
+				position += length;
+				anchor = position;
+			}
+		}
+
+		WriteSequence(destination, source + anchor, sourceSize - anchor, 0, 0);
+
+		return destination.size() - start;
+	}
+
+	bool Decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize)
+	{
+		const uint8_t* input = source;
+		const uint8_t* inputEnd = source + sourceSize;
+
+		size_t output = 0;
+
+		while (input < inputEnd)
+		{
+			uint8_t token = *input++;
+
+			size_t literalLength = token >> 4;
+
+			if (literalLength == 15)
+			{
+				uint8_t byte;
+
+				do
+				{
+					if (input >= inputEnd)
+					{
+						return false;
+					}
+
+					byte = *input++;
+					literalLength += byte;
+				} while (byte == 255);
+			}
+
+			if (literalLength > static_cast<size_t>(inputEnd - input) || literalLength > destinationSize - output)
+			{
+				return false;
+			}
+
+			std::memcpy(destination + output, input, literalLength);
+
+			input += literalLength;
+			output += literalLength;
+
+			// The last sequence has no match.
+			if (input == inputEnd)
+			{
+				break;
+			}
+
+			if (inputEnd - input < 2)
+			{
+				return false;
+			}
+
+			size_t offset = input[0] | (size_t(input[1]) << 8);
+
+			input += 2;
+
+			if (offset == 0 || offset > output)
+			{
+				return false;
+			}
+
+			size_t matchLength = token & 0xF;
+
+			if (matchLength == 15)
+			{
+				uint8_t byte;
+
+				do
+				{
+					if (input >= inputEnd)
+					{
+						return false;
+					}
+
+					byte = *input++;
+					matchLength += byte;
+				} while (byte == 255);
+			}
+
+			matchLength += MinMatch;
+
+			if (matchLength > destinationSize - output)
+			{
+				return false;
+			}
+
+			// Byte by byte since the match may overlap what it is writing.
+			const uint8_t* match = destination + output - offset;
+
+			for (size_t i = 0; i < matchLength; i++)
+			{
+				destination[output + i] = match[i];
+			}
+
+			output += matchLength;
+		}
+
+		return output == destinationSize;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "Types.h"
+
+// LZ4 block format, compatible with the reference implementation's LZ4_compress_default/LZ4_decompress_safe.
+// The compressor favours speed over ratio, the decompressor is bounds checked so corrupt archives fail instead of crashing.
+namespace Velkro::LZ4
+{
+	size_t GetMaxCompressedSize(size_t size);
+
+	size_t Compress(const uint8_t* source, size_t sourceSize, std::vector<uint8_t>& destination); // Appends to destination, returns the compressed size.
+	bool Decompress(const uint8_t* source, size_t sourceSize, uint8_t* destination, size_t destinationSize); // destinationSize must be the exact original size.
+}
\ No newline at end of file
@@ -0,0 +1,830 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace Velkro::MeshOptimizer
+{
+	static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+	// Post-transform cache size assumed for scoring and simulation, close to what current GPUs effectively reuse.
+	static constexpr int CacheSize = 32;
+
+	// Miss ratio overdraw clusters may cost on top of the cache optimized order.
+	static constexpr float OverdrawThreshold = 1.05f;
+
+	static uint32_t HashBytes(const uint8_t* bytes, size_t size)
+	{
+		uint32_t hash = 2166136261u;
+
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ bytes[i]) * 16777619u;
+		}
+
+		return hash;
+	}
+
+	size_t WeldVertices(uint32_t* remap, const void* vertices, size_t vertexCount, size_t vertexSize)
+	{
+		const uint8_t* bytes = static_cast<const uint8_t*>(vertices);
+
+		size_t tableSize = 1;
+
+		while (tableSize < vertexCount * 2)
+		{
+			tableSize *= 2;
+		}
+
+		std::vector<uint32_t> table(tableSize, InvalidIndex);
+
+		size_t uniqueCount = 0;
+
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			const uint8_t* vertex = bytes + i * vertexSize;
+
+			size_t slot = HashBytes(vertex, vertexSize) & (tableSize - 1);
+
+			while (true)
+			{
+				uint32_t entry = table[slot];
+
+				if (entry == InvalidIndex)
+				{
+					table[slot] = static_cast<uint32_t>(i);
+					remap[i] = static_cast<uint32_t>(uniqueCount++);
+
+					break;
+				}
+
+				if (std::memcmp(bytes + entry * vertexSize, vertex, vertexSize) == 0)
+				{
+					remap[i] = remap[entry];
+
+					break;
+				}
+
+				slot = (slot + 1) & (tableSize - 1);
+			}
+		}
+
+		return uniqueCount;
+	}
+
+	void RemapVertices(void* destination, const void* vertices, size_t vertexCount, size_t vertexSize, const uint32_t* remap)
+	{
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			std::memcpy(static_cast<uint8_t*>(destination) + remap[i] * vertexSize, static_cast<const uint8_t*>(vertices) + i * vertexSize, vertexSize);
+		}
+	}
+
+	void RemapIndices(uint32_t* destination, const uint32_t* indices, size_t indexCount, const uint32_t* remap)
+	{
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			destination[i] = remap[indices[i]];
+		}
+	}
+
+	static float GetVertexScore(int cachePosition, uint32_t liveTriangles)
+	{
+		if (liveTriangles == 0)
+		{
+			return -1.0f;
+		}
+
+		float score = 0.0f;
+
+		if (cachePosition >= 0)
+		{
+			// The last triangle's vertices get a fixed score, so the next triangle doesn't just fan around one of them.
+			if (cachePosition < 3)
+			{
+				score = 0.75f;
+			}
+			else
+			{
+				score = std::pow(1.0f - static_cast<float>(cachePosition - 3) / (CacheSize - 3), 1.5f);
+			}
+		}
+
+		// Vertices with few triangles left are finished off first, so they don't come back later as cache misses.
+		return score + 2.0f / std::sqrt(static_cast<float>(liveTriangles));
+	}
+
+	void OptimizeVertexCache(uint32_t* destination, const uint32_t* indices, size_t indexCount, size_t vertexCount)
+	{
+		size_t triangleCount = indexCount / 3;
+
+		if (triangleCount == 0)
+		{
+			return;
+		}
+
+		std::vector<uint32_t> indexCopy(indices, indices + indexCount); // Allows destination to be indices.
+
+		// Triangles of every vertex, the live ones are kept at the front of each list.
+		std::vector<uint32_t> liveTriangles(vertexCount, 0);
+
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			liveTriangles[indexCopy[i]]++;
+		}
+
+		std::vector<uint32_t> offsets(vertexCount + 1, 0);
+
+		for (size_t vertex = 0; vertex < vertexCount; vertex++)
+		{
+			offsets[vertex + 1] = offsets[vertex] + liveTriangles[vertex];
+		}
+
+		std::vector<uint32_t> adjacency(indexCount);
+		std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			adjacency[fill[indexCopy[i]]++] = static_cast<uint32_t>(i / 3);
+		}
+
+		std::vector<int> cachePositions(vertexCount, -1);
+		std::vector<float> vertexScores(vertexCount);
+
+		for (size_t vertex = 0; vertex < vertexCount; vertex++)
+		{
+			vertexScores[vertex] = GetVertexScore(-1, liveTriangles[vertex]);
+		}
+
+		std::vector<float> triangleScores(triangleCount);
+		std::vector<bool> emitted(triangleCount, false);
+
+		uint32_t best = 0;
+
+		for (size_t triangle = 0; triangle < triangleCount; triangle++)
+		{
+			const uint32_t* corners = &indexCopy[triangle * 3];
+
+			triangleScores[triangle] = vertexScores[corners[0]] + vertexScores[corners[1]] + vertexScores[corners[2]];
+
+			if (triangleScores[triangle] > triangleScores[best])
+			{
+				best = static_cast<uint32_t>(triangle);
+			}
+		}
+
+		uint32_t cache[CacheSize + 3];
+		int cacheCount = 0;
+
+		size_t restart = 0;
+
+		for (size_t output = 0; output < triangleCount; output++)
+		{
+			// Nothing in the cache has triangles left, carry on with the first one not drawn yet.
+			if (best == InvalidIndex)
+			{
+				while (emitted[restart])
+				{
+					restart++;
+				}
+
+				best = static_cast<uint32_t>(restart);
+			}
+
+			const uint32_t* corners = &indexCopy[best * 3];
+
+			destination[output * 3] = corners[0];
+			destination[output * 3 + 1] = corners[1];
+			destination[output * 3 + 2] = corners[2];
+
+			emitted[best] = true;
+
+			for (int corner = 0; corner < 3; corner++)
+			{
+				uint32_t vertex = corners[corner];
+
+				uint32_t* triangles = &adjacency[offsets[vertex]];
+
+				for (uint32_t i = 0; i < liveTriangles[vertex]; i++)
+				{
+					if (triangles[i] == best)
+					{
+						std::swap(triangles[i], triangles[liveTriangles[vertex] - 1]);
+						liveTriangles[vertex]--;
+
+						break;
+					}
+				}
+			}
+
+			// The drawn triangle's vertices move to the front, pushing the rest back and the oldest out.
+			uint32_t newCache[CacheSize + 3];
+			int newCacheCount = 0;
+
+			for (int corner = 0; corner < 3; corner++)
+			{
+				if (std::find(newCache, newCache + newCacheCount, corners[corner]) == newCache + newCacheCount)
+				{
+					newCache[newCacheCount++] = corners[corner];
+				}
+			}
+
+			for (int i = 0; i < cacheCount; i++)
+			{
+				if (std::find(newCache, newCache + newCacheCount, cache[i]) == newCache + newCacheCount)
+				{
+					newCache[newCacheCount++] = cache[i];
+				}
+			}
+
+			for (int i = 0; i < newCacheCount; i++)
+			{
+				uint32_t vertex = newCache[i];
+
+				cachePositions[vertex] = i < CacheSize ? i : -1;
+				vertexScores[vertex] = GetVertexScore(cachePositions[vertex], liveTriangles[vertex]);
+			}
+
+			// Only triangles touching the cache changed score, the best of them is drawn next.
+			best = InvalidIndex;
+
+			float bestScore = -1.0f;
+
+			for (int i = 0; i < newCacheCount; i++)
+			{
+				uint32_t vertex = newCache[i];
+
+				for (uint32_t j = 0; j < liveTriangles[vertex]; j++)
+				{
+					uint32_t triangle = adjacency[offsets[vertex] + j];
+
+					const uint32_t* triangleCorners = &indexCopy[triangle * 3];
+
+					float score = vertexScores[triangleCorners[0]] + vertexScores[triangleCorners[1]] + vertexScores[triangleCorners[2]];
+
+					triangleScores[triangle] = score;
+
+					if (score > bestScore)
+					{
+						bestScore = score;
+						best = triangle;
+					}
+				}
+			}
+
+			cacheCount = std::min(newCacheCount, CacheSize);
+
+			std::copy(newCache, newCache + cacheCount, cache);
+		}
+	}
+
+	void OptimizeOverdraw(uint32_t* destination, const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount)
+	{
+		size_t triangleCount = indexCount / 3;
+
+		if (triangleCount == 0)
+		{
+			return;
+		}
+
+		std::vector<uint32_t> indexCopy(indices, indices + indexCount);
+
+		// Clusters are cut as in Sander et al.'s Tipsify: the simulated FIFO cache starts cold for every cluster, and a cluster
+		// ends once its own miss ratio is back within OverdrawThreshold of the whole order's. Any order of such clusters keeps
+		// close to the cache optimized miss ratio.
+		float targetRatio = GetCacheMissRatio(indexCopy.data(), indexCount, vertexCount) * OverdrawThreshold;
+
+		std::vector<size_t> clusterStarts = { 0 };
+
+		std::vector<uint32_t> cacheTimes(vertexCount, 0);
+		uint32_t time = CacheSize + 1;
+
+		size_t clusterMisses = 0;
+
+		for (size_t triangle = 0; triangle < triangleCount; triangle++)
+		{
+			for (int corner = 0; corner < 3; corner++)
+			{
+				uint32_t vertex = indexCopy[triangle * 3 + corner];
+
+				if (time - cacheTimes[vertex] > CacheSize)
+				{
+					cacheTimes[vertex] = time++;
+					clusterMisses++;
+				}
+			}
+
+			size_t clusterTriangles = triangle + 1 - clusterStarts.back();
+
+			if (triangle + 1 < triangleCount && clusterMisses <= targetRatio * clusterTriangles)
+			{
+				clusterStarts.push_back(triangle + 1);
+
+				clusterMisses = 0;
+				time += CacheSize + 1; // Empties the cache.
+			}
+		}
+
+		clusterStarts.push_back(triangleCount);
+
+		size_t clusterCount = clusterStarts.size() - 1;
+
+		struct Cluster
+		{
+			float centroid[3];
+			float normal[3];
+			float area;
+
+			float sortKey;
+		};
+
+		std::vector<Cluster> clusters(clusterCount);
+
+		float meshCentroid[3] = { 0.0f, 0.0f, 0.0f };
+		float meshArea = 0.0f;
+
+		for (size_t cluster = 0; cluster < clusterCount; cluster++)
+		{
+			Cluster& data = clusters[cluster];
+			data = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f }, 0.0f, 0.0f };
+
+			for (size_t triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; triangle++)
+			{
+				const float* a = positions + indexCopy[triangle * 3] * 3;
+				const float* b = positions + indexCopy[triangle * 3 + 1] * 3;
+				const float* c = positions + indexCopy[triangle * 3 + 2] * 3;
+
+				float ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+				float ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+
+				float normal[3] = { ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0] };
+
+				float area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+				for (int axis = 0; axis < 3; axis++)
+				{
+					data.centroid[axis] += (a[axis] + b[axis] + c[axis]) / 3.0f * area;
+					data.normal[axis] += normal[axis];
+				}
+
+				data.area += area;
+			}
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				meshCentroid[axis] += data.centroid[axis];
+
+				data.centroid[axis] /= data.area > 0.0f ? data.area : 1.0f;
+			}
+
+			meshArea += data.area;
+		}
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			meshCentroid[axis] /= meshArea > 0.0f ? meshArea : 1.0f;
+		}
+
+		// Clusters far out along their own normal are likely in front of the rest from wherever they are visible.
+		for (Cluster& cluster : clusters)
+		{
+			float length = std::sqrt(cluster.normal[0] * cluster.normal[0] + cluster.normal[1] * cluster.normal[1] + cluster.normal[2] * cluster.normal[2]);
+
+			float key = 0.0f;
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				key += (cluster.centroid[axis] - meshCentroid[axis]) * (length > 0.0f ? cluster.normal[axis] / length : 0.0f);
+			}
+
+			cluster.sortKey = key;
+		}
+
+		std::vector<uint32_t> order(clusterCount);
+
+		for (size_t cluster = 0; cluster < clusterCount; cluster++)
+		{
+			order[cluster] = static_cast<uint32_t>(cluster);
+		}
+
+		std::stable_sort(order.begin(), order.end(), [&clusters](uint32_t a, uint32_t b) { return clusters[a].sortKey > clusters[b].sortKey; });
+
+		size_t output = 0;
+
+		for (uint32_t cluster : order)
+		{
+			size_t first = clusterStarts[cluster] * 3;
+			size_t last = clusterStarts[cluster + 1] * 3;
+
+			std::copy(indexCopy.begin() + first, indexCopy.begin() + last, destination + output);
+
+			output += last - first;
+		}
+	}
+
+	size_t OptimizeVertexFetch(void* destination, uint32_t* indices, size_t indexCount, const void* vertices, size_t vertexCount, size_t vertexSize)
+	{
+		std::vector<uint32_t> remap(vertexCount, InvalidIndex);
+
+		size_t nextVertex = 0;
+
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			uint32_t vertex = indices[i];
+
+			if (remap[vertex] == InvalidIndex)
+			{
+				std::memcpy(static_cast<uint8_t*>(destination) + nextVertex * vertexSize, static_cast<const uint8_t*>(vertices) + vertex * vertexSize, vertexSize);
+
+				remap[vertex] = static_cast<uint32_t>(nextVertex++);
+			}
+
+			indices[i] = remap[vertex];
+		}
+
+		return nextVertex;
+	}
+
+	struct Grid
+	{
+		float minimum[3];
+		float cellSize;
+
+		int resolution;
+	};
+
+	static uint64_t GetCell(const Grid& grid, const float* position)
+	{
+		uint64_t cell = 0;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			int coordinate = static_cast<int>((position[axis] - grid.minimum[axis]) / grid.cellSize);
+
+			coordinate = std::clamp(coordinate, 0, grid.resolution - 1);
+
+			cell |= static_cast<uint64_t>(coordinate) << (axis * 21);
+		}
+
+		return cell;
+	}
+
+	static size_t CountClusteredIndices(const std::vector<uint64_t>& cells, const uint32_t* indices, size_t indexCount)
+	{
+		size_t count = 0;
+
+		for (size_t i = 0; i < indexCount; i += 3)
+		{
+			uint64_t a = cells[indices[i]], b = cells[indices[i + 1]], c = cells[indices[i + 2]];
+
+			if (a != b && b != c && a != c)
+			{
+				count += 3;
+			}
+		}
+
+		return count;
+	}
+
+	size_t SimplifyClustered(uint32_t* destination, const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t targetIndexCount)
+	{
+		if (indexCount == 0)
+		{
+			return 0;
+		}
+
+		Grid grid;
+
+		float maximum[3];
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			grid.minimum[axis] = maximum[axis] = positions[indices[0] * 3 + axis];
+		}
+
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				grid.minimum[axis] = std::min(grid.minimum[axis], positions[indices[i] * 3 + axis]);
+				maximum[axis] = std::max(maximum[axis], positions[indices[i] * 3 + axis]);
+			}
+		}
+
+		float extent = std::max(maximum[0] - grid.minimum[0], std::max(maximum[1] - grid.minimum[1], maximum[2] - grid.minimum[2]));
+
+		if (extent <= 0.0f)
+		{
+			return 0;
+		}
+
+		std::vector<uint64_t> cells(vertexCount);
+
+		auto assignCells = [&](int resolution)
+		{
+			grid.resolution = resolution;
+			grid.cellSize = extent / resolution;
+
+			for (size_t i = 0; i < indexCount; i++)
+			{
+				cells[indices[i]] = GetCell(grid, positions + indices[i] * 3);
+			}
+		};
+
+		// Finer grids keep more triangles, search for the finest one under the target.
+		int low = 1, high = 1 << 20;
+
+		while (low < high)
+		{
+			int resolution = low + (high - low + 1) / 2;
+
+			assignCells(resolution);
+
+			if (CountClusteredIndices(cells, indices, indexCount) <= targetIndexCount)
+			{
+				low = resolution;
+			}
+			else
+			{
+				high = resolution - 1;
+			}
+		}
+
+		assignCells(low);
+
+		// Each cell is represented by the vertex closest to the average of the vertices in it.
+		struct CellData
+		{
+			float sum[3];
+			uint32_t count;
+
+			uint32_t representative;
+			float distance;
+		};
+
+		std::unordered_map<uint64_t, CellData> cellData;
+		cellData.reserve(vertexCount);
+
+		std::vector<bool> visited(vertexCount, false);
+
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			uint32_t vertex = indices[i];
+
+			if (visited[vertex])
+			{
+				continue;
+			}
+
+			visited[vertex] = true;
+
+			CellData& data = cellData.try_emplace(cells[vertex], CellData{ { 0.0f, 0.0f, 0.0f }, 0, InvalidIndex, 0.0f }).first->second;
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				data.sum[axis] += positions[vertex * 3 + axis];
+			}
+
+			data.count++;
+		}
+
+		for (size_t vertex = 0; vertex < vertexCount; vertex++)
+		{
+			if (!visited[vertex])
+			{
+				continue;
+			}
+
+			CellData& data = cellData[cells[vertex]];
+
+			float distance = 0.0f;
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				float delta = positions[vertex * 3 + axis] - data.sum[axis] / data.count;
+
+				distance += delta * delta;
+			}
+
+			if (data.representative == InvalidIndex || distance < data.distance)
+			{
+				data.representative = static_cast<uint32_t>(vertex);
+				data.distance = distance;
+			}
+		}
+
+		size_t output = 0;
+
+		for (size_t i = 0; i < indexCount; i += 3)
+		{
+			uint64_t a = cells[indices[i]], b = cells[indices[i + 1]], c = cells[indices[i + 2]];
+
+			if (a == b || b == c || a == c)
+			{
+				continue;
+			}
+
+			destination[output++] = cellData[a].representative;
+			destination[output++] = cellData[b].representative;
+			destination[output++] = cellData[c].representative;
+		}
+
+		return output;
+	}
+
+	bool FitsShortIndices(size_t vertexCount)
+	{
+		return vertexCount <= 0x10000;
+	}
+
+	void ConvertToShortIndices(uint16_t* destination, const uint32_t* indices, size_t indexCount)
+	{
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			destination[i] = static_cast<uint16_t>(indices[i]);
+		}
+	}
+
+	float GetCacheMissRatio(const uint32_t* indices, size_t indexCount, size_t vertexCount)
+	{
+		if (indexCount < 3)
+		{
+			return 0.0f;
+		}
+
+		std::vector<uint32_t> cacheTimes(vertexCount, 0);
+		uint32_t time = CacheSize + 1;
+
+		size_t misses = 0;
+
+		for (size_t i = 0; i < indexCount; i++)
+		{
+			if (time - cacheTimes[indices[i]] > CacheSize)
+			{
+				cacheTimes[indices[i]] = time++;
+				misses++;
+			}
+		}
+
+		return static_cast<float>(misses) / (indexCount / 3);
+	}
+
+	void ProcessMesh(ProcessedMesh& mesh, const void* vertices, size_t vertexCount, size_t vertexSize, const float* positions, const uint32_t* indices, const size_t* submeshIndexCounts, size_t submeshCount, const MeshOptions& options)
+	{
+		size_t indexCount = 0;
+
+		for (size_t i = 0; i < submeshCount; i++)
+		{
+			indexCount += submeshIndexCounts[i];
+		}
+
+		const uint8_t* bytes = static_cast<const uint8_t*>(vertices);
+
+		mesh.vertices.assign(bytes, bytes + vertexCount * vertexSize);
+		mesh.vertexCount = vertexCount;
+
+		std::vector<float> meshPositions(positions, positions + vertexCount * 3);
+		std::vector<uint32_t> meshIndices(indices, indices + indexCount);
+
+		if (options.weld)
+		{
+			std::vector<uint32_t> remap(vertexCount);
+
+			mesh.vertexCount = WeldVertices(remap.data(), vertices, vertexCount, vertexSize);
+
+			mesh.vertices.resize(mesh.vertexCount * vertexSize);
+			meshPositions.resize(mesh.vertexCount * 3);
+
+			RemapVertices(mesh.vertices.data(), vertices, vertexCount, vertexSize, remap.data());
+			RemapVertices(meshPositions.data(), positions, vertexCount, sizeof(float) * 3, remap.data());
+			RemapIndices(meshIndices.data(), meshIndices.data(), meshIndices.size(), remap.data());
+		}
+
+		// Every LOD is simplified from the full mesh, so errors don't stack up from one LOD to the next. Submeshes that
+		// stop shrinking keep their previous LOD, and LODs stop once none of them shrink.
+		std::vector<std::vector<std::vector<uint32_t>>> lodIndices(1);
+
+		for (size_t i = 0, first = 0; i < submeshCount; first += submeshIndexCounts[i++])
+		{
+			lodIndices[0].emplace_back(meshIndices.begin() + first, meshIndices.begin() + first + submeshIndexCounts[i]);
+		}
+
+		for (int lod = 1; lod < options.lodCount; lod++)
+		{
+			std::vector<std::vector<uint32_t>> level;
+
+			bool reduced = false;
+
+			for (size_t i = 0; i < submeshCount; i++)
+			{
+				const std::vector<uint32_t>& full = lodIndices.front()[i];
+				const std::vector<uint32_t>& previous = lodIndices.back()[i];
+
+				size_t target = static_cast<size_t>(previous.size() / 3 * options.lodReduction) * 3;
+
+				std::vector<uint32_t> simplified(full.size());
+				simplified.resize(SimplifyClustered(simplified.data(), full.data(), full.size(), meshPositions.data(), mesh.vertexCount, target));
+
+				if (simplified.empty() || simplified.size() >= previous.size())
+				{
+					level.push_back(previous);
+				}
+				else
+				{
+					level.push_back(std::move(simplified));
+
+					reduced = true;
+				}
+			}
+
+			if (!reduced)
+			{
+				break;
+			}
+
+			lodIndices.push_back(std::move(level));
+		}
+
+		mesh.indices.clear();
+		mesh.lods.clear();
+		mesh.submeshes.clear();
+		mesh.lodScreenSizes.clear();
+		mesh.submeshCount = submeshCount;
+
+		float screenSize = options.lodScreenSize;
+
+		for (size_t lod = 0; lod < lodIndices.size(); lod++)
+		{
+			size_t lodFirst = mesh.indices.size();
+
+			for (std::vector<uint32_t>& submeshIndices : lodIndices[lod])
+			{
+				if (options.optimizeCache)
+				{
+					OptimizeVertexCache(submeshIndices.data(), submeshIndices.data(), submeshIndices.size(), mesh.vertexCount);
+				}
+
+				if (options.optimizeOverdraw)
+				{
+					OptimizeOverdraw(submeshIndices.data(), submeshIndices.data(), submeshIndices.size(), meshPositions.data(), mesh.vertexCount);
+				}
+
+				mesh.submeshes.push_back({ mesh.indices.size(), submeshIndices.size() });
+				mesh.indices.insert(mesh.indices.end(), submeshIndices.begin(), submeshIndices.end());
+			}
+
+			mesh.lods.push_back({ lodFirst, mesh.indices.size() - lodFirst });
+
+			// LOD 0 is used at any size, every LOD after it once the mesh is smaller than its screen size.
+			mesh.lodScreenSizes.push_back(lod == 0 ? FLT_MAX : screenSize);
+
+			if (lod > 0)
+			{
+				screenSize *= 0.5f;
+			}
+		}
+
+		// Bounds of the vertices LOD 0 uses, the same set fetch ordering keeps.
+		float minimum[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		float maximum[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+		for (size_t i = 0; i < mesh.lods.front().indexCount; i++)
+		{
+			const float* position = meshPositions.data() + mesh.indices[i] * 3;
+
+			for (int axis = 0; axis < 3; axis++)
+			{
+				minimum[axis] = std::min(minimum[axis], position[axis]);
+				maximum[axis] = std::max(maximum[axis], position[axis]);
+			}
+		}
+
+		float extent = 0.0f;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			mesh.centre[axis] = indexCount ? (minimum[axis] + maximum[axis]) * 0.5f : 0.0f;
+
+			extent += indexCount ? (maximum[axis] - minimum[axis]) * (maximum[axis] - minimum[axis]) : 0.0f;
+		}
+
+		mesh.radius = std::sqrt(extent) * 0.5f;
+
+		// Fetch order follows LOD 0, every lower LOD only uses a subset of its vertices.
+		if (options.optimizeFetch)
+		{
+			std::vector<uint8_t> fetchVertices(mesh.vertices.size());
+
+			mesh.vertexCount = OptimizeVertexFetch(fetchVertices.data(), mesh.indices.data(), mesh.indices.size(), mesh.vertices.data(), mesh.vertexCount, vertexSize);
+
+			fetchVertices.resize(mesh.vertexCount * vertexSize);
+
+			mesh.vertices = std::move(fetchVertices);
+		}
+	}
+}
\ No newline at end of file
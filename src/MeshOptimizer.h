@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Types.h"
+
+// Offline style mesh processing, run once when a mesh is set or cooked rather than every frame. Vertices are handled as
+// opaque blobs of vertexSize bytes, functions that need geometry take positions as three floats per vertex.
+namespace Velkro
+{
+	struct MeshOptions
+	{
+		bool weld = true; // Merges byte identical vertices.
+		bool optimizeCache = true;
+		bool optimizeOverdraw = true;
+		bool optimizeFetch = true;
+
+		int lodCount = 4; // Including the full mesh, fewer are kept when simplifying stops paying off.
+		float lodReduction = 0.5f; // Triangles of each LOD relative to the one before it.
+		float lodScreenSize = 0.25f; // Projected height, as a fraction of the screen, below which LOD 1 is used. Halves for every LOD after it.
+	};
+}
+
+namespace Velkro::MeshOptimizer
+{
+	// Fills remap with the new index of every vertex, byte identical vertices share one. Returns the unique vertex count.
+	size_t WeldVertices(uint32_t* remap, const void* vertices, size_t vertexCount, size_t vertexSize);
+
+	void RemapVertices(void* destination, const void* vertices, size_t vertexCount, size_t vertexSize, const uint32_t* remap);
+	void RemapIndices(uint32_t* destination, const uint32_t* indices, size_t indexCount, const uint32_t* remap);
+
+	// Reorders triangles so vertices are reused while they are still in the post-transform cache (Forsyth's algorithm).
+	void OptimizeVertexCache(uint32_t* destination, const uint32_t* indices, size_t indexCount, size_t vertexCount);
+
+	// Splits cache optimized triangles into clusters that each keep within 5% of their vertex cache miss ratio, and draws
+	// outward facing clusters first so more of the mesh fails the depth test.
+	void OptimizeOverdraw(uint32_t* destination, const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount);
+
+	// Moves vertices into the order the indices first use them and rewrites the indices to match, unused vertices are
+	// dropped. Returns the vertex count left in destination.
+	size_t OptimizeVertexFetch(void* destination, uint32_t* indices, size_t indexCount, const void* vertices, size_t vertexCount, size_t vertexSize);
+
+	// Vertex clustering, snaps every vertex to the most central vertex of its grid cell and drops the triangles that
+	// collapse. The grid is the finest one leaving at most targetIndexCount indices, and the output only uses existing
+	// vertices, so every LOD can share the full mesh's vertex buffer. Returns the index count written.
+	size_t SimplifyClustered(uint32_t* destination, const uint32_t* indices, size_t indexCount, const float* positions, size_t vertexCount, size_t targetIndexCount);
+
+	bool FitsShortIndices(size_t vertexCount);
+	void ConvertToShortIndices(uint16_t* destination, const uint32_t* indices, size_t indexCount);
+
+	float GetCacheMissRatio(const uint32_t* indices, size_t indexCount, size_t vertexCount); // Vertex shader runs per triangle, 0.5 to 3.
+
+	// Output of ProcessMesh. Every LOD holds all submeshes back to back, so a LOD can be drawn in one call.
+	struct ProcessedMesh
+	{
+		struct Range
+		{
+			size_t firstIndex, indexCount;
+		};
+
+		std::vector<uint8_t> vertices;
+		size_t vertexCount = 0;
+
+		std::vector<uint32_t> indices;
+
+		size_t submeshCount = 0;
+
+		std::vector<Range> lods;
+		std::vector<Range> submeshes; // submeshCount per LOD, LOD 0 first.
+		std::vector<float> lodScreenSizes; // Used while the projected height is below this, FLT_MAX for LOD 0.
+
+		float centre[3] = {}, radius = 0.0f; // Bounding sphere.
+	};
+
+	// Everything MeshComponent and VelkroCook do to a mesh: welding, LODs simplified from the full mesh, cache and overdraw
+	// order per submesh and LOD, then fetch order over the result. Submeshes are consecutive runs of indices.
+	void ProcessMesh(ProcessedMesh& mesh, const void* vertices, size_t vertexCount, size_t vertexSize, const float* positions, const uint32_t* indices, const size_t* submeshIndexCounts, size_t submeshCount, const MeshOptions& options);
+}
\ No newline at end of file
@@ -0,0 +1,386 @@
+#include "Particles.h"
+
+#include <glad/glad.h>
+
+#include <atomic>
+#include <vector>
+
+#include "Renderer.h"
+#include "CommandBuffer.h"
+#include "FramePipeline.h"
+#include "Log.h"
+
+namespace Velkro::Particles
+{
+	struct Emitter
+	{
+		uint32_t capacity;
+
+		uint32_t prepareProgram, simulateProgram, emitProgram, finalizeProgram;
+		uint32_t renderProgram;
+
+		uint32_t particleBuffers[2];
+		uint32_t counterBuffer;
+		uint32_t parameterBuffer;
+		uint32_t vertexArray;
+
+		int source = 0; // Buffer holding the live particles, only touched on the context thread.
+
+		std::atomic<uint32_t> textureID = 0;
+	};
+
+	struct Particle
+	{
+		float positionAge[4];
+		float velocityLifetime[4];
+	};
+
+	// Offsets into the counter buffer, which doubles as the indirect dispatch and draw buffer.
+	static constexpr size_t SimulateDispatchOffset = 16;
+	static constexpr size_t EmitDispatchOffset = 32;
+	static constexpr size_t DrawOffset = 48;
+	static constexpr size_t CounterBufferSize = 64;
+
+	static const char* SharedSource = R"(
+struct Particle
+{
+	vec4 positionAge;
+	vec4 velocityLifetime;
+};
+
+layout(std140, binding = 0) uniform Parameters
+{
+	vec4 u_Position;
+	vec4 u_PositionSpread;
+	vec4 u_Velocity;
+	vec4 u_VelocitySpread;
+	vec4 u_Gravity;
+	vec4 u_StartColour;
+	vec4 u_EndColour;
+	vec4 u_Sizes;
+	uvec4 u_Counts; // Emit count, capacity, seed.
+};
+)";
+
+	static const char* ComputeSource = R"(
+#if defined(PREPARE) || defined(FINALIZE)
+layout(local_size_x = 1) in;
+#else
+layout(local_size_x = 256) in;
+#endif
+
+layout(std430, binding = 0) readonly buffer SourceParticles
+{
+	Particle sourceParticles[];
+};
+
+layout(std430, binding = 1) writeonly buffer DestinationParticles
+{
+	Particle destinationParticles[];
+};
+
+layout(std430, binding = 2) buffer Counters
+{
+	uint sourceCount;
+	uint destinationCount;
+	uvec2 padding;
+	uvec4 simulateDispatch;
+	uvec4 emitDispatch;
+	uvec4 draw;
+};
+
+uint Hash(uint value)
+{
+	value ^= value >> 16;
+	value *= 0x7FEB352Du;
+	value ^= value >> 15;
+	value *= 0x846CA68Bu;
+	value ^= value >> 16;
+
+	return value;
+}
+
+float Random(inout uint state)
+{
+	state = Hash(state);
+
+	return float(state) / 4294967295.0;
+}
+
+vec3 RandomSigned(inout uint state)
+{
+	return vec3(Random(state), Random(state), Random(state)) * 2.0 - 1.0;
+}
+
+void main()
+{
+	uint index = gl_GlobalInvocationID.x;
+
+#if defined(PREPARE)
+	simulateDispatch = uvec4((sourceCount + 255u) / 256u, 1u, 1u, 0u);
+	emitDispatch = uvec4((u_Counts.x + 255u) / 256u, 1u, 1u, 0u);
+
+	destinationCount = 0u;
+#elif defined(SIMULATE)
+	if (index >= sourceCount)
+	{
+		return;
+	}
+
+	Particle particle = sourceParticles[index];
+
+	float deltaTime = u_Position.w;
+
+	particle.positionAge.w += deltaTime;
+
+	if (particle.positionAge.w >= particle.velocityLifetime.w)
+	{
+		return;
+	}
+
+	particle.velocityLifetime.xyz += u_Gravity.xyz * deltaTime;
+	particle.positionAge.xyz += particle.velocityLifetime.xyz * deltaTime;
+
+	destinationParticles[atomicAdd(destinationCount, 1u)] = particle;
+#elif defined(EMIT)
+	if (index >= u_Counts.x)
+	{
+		return;
+	}
+
+	uint slot = atomicAdd(destinationCount, 1u);
+
+	if (slot >= u_Counts.y)
+	{
+		return;
+	}
+
+	uint state = Hash(u_Counts.z ^ Hash(index));
+
+	Particle particle;
+	particle.positionAge = vec4(u_Position.xyz + RandomSigned(state) * u_PositionSpread.xyz, 0.0);
+	particle.velocityLifetime = vec4(u_Velocity.xyz + RandomSigned(state) * u_VelocitySpread.xyz, max(u_Velocity.w + (Random(state) * 2.0 - 1.0) * u_VelocitySpread.w, 0.001));
+
+	destinationParticles[slot] = particle;
+#elif defined(FINALIZE)
+	sourceCount = min(destinationCount, u_Counts.y);
+
+	draw = uvec4(6u, sourceCount, 0u, 0u);
+#endif
+}
+)";
+
+	static const char* VertexSource = R"(
+layout(std430, binding = 0) readonly buffer Particles
+{
+	Particle particles[];
+};
+
+uniform mat4 u_Projection;
+uniform mat4 u_View;
+
+out vec2 UV;
+out vec4 Colour;
+
+const vec2 Corners[6] = vec2[](vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(0.5, 0.5), vec2(-0.5, -0.5), vec2(0.5, 0.5), vec2(-0.5, 0.5));
+
+void main()
+{
+	Particle particle = particles[gl_InstanceID];
+
+	float age = clamp(particle.positionAge.w / particle.velocityLifetime.w, 0.0, 1.0);
+	float size = mix(u_Sizes.x, u_Sizes.y, age);
+
+	// Camera facing, the view matrix rows are the camera's right and up axes.
+	vec3 right = vec3(u_View[0][0], u_View[1][0], u_View[2][0]);
+	vec3 up = vec3(u_View[0][1], u_View[1][1], u_View[2][1]);
+
+	vec2 corner = Corners[gl_VertexID];
+
+	vec3 position = particle.positionAge.xyz + (right * corner.x + up * corner.y) * size;
+
+	gl_Position = u_Projection * u_View * vec4(position, 1.0);
+
+	UV = corner + 0.5;
+	Colour = mix(u_StartColour, u_EndColour, age);
+}
+)";
+
+	static const char* FragmentSource = R"(
+in vec2 UV;
+in vec4 Colour;
+
+out vec4 FragColour;
+
+uniform sampler2D u_Texture;
+uniform int u_Textured;
+
+void main()
+{
+	vec4 texel = u_Textured != 0 ? texture(u_Texture, UV) : vec4(1.0, 1.0, 1.0, 1.0 - smoothstep(0.3, 0.5, length(UV - 0.5)));
+
+	FragColour = texel * Colour;
+}
+)";
+
+	static std::string Assemble(const char* source, bool shared)
+	{
+		return std::string("#version 460 core\n") + (shared ? SharedSource : "") + source;
+	}
+
+	Emitter* CreateEmitter(uint32_t capacity)
+	{
+		Emitter* emitter = new Emitter();
+		emitter->capacity = capacity;
+
+		std::string computeSource = Assemble(ComputeSource, true);
+
+		emitter->prepareProgram = Renderer::LoadComputeShaderFromSource(computeSource.c_str(), { "PREPARE" });
+		emitter->simulateProgram = Renderer::LoadComputeShaderFromSource(computeSource.c_str(), { "SIMULATE" });
+		emitter->emitProgram = Renderer::LoadComputeShaderFromSource(computeSource.c_str(), { "EMIT" });
+		emitter->finalizeProgram = Renderer::LoadComputeShaderFromSource(computeSource.c_str(), { "FINALIZE" });
+
+		emitter->renderProgram = Renderer::LoadShaderFromSource(Assemble(VertexSource, true).c_str(), Assemble(FragmentSource, false).c_str());
+
+		glCreateBuffers(2, emitter->particleBuffers);
+
+		for (uint32_t buffer : emitter->particleBuffers)
+		{
+			glNamedBufferStorage(buffer, static_cast<GLsizeiptr>(capacity) * sizeof(Particle), nullptr, 0);
+		}
+
+		const uint32_t counters[CounterBufferSize / sizeof(uint32_t)] = {};
+
+		glCreateBuffers(1, &emitter->counterBuffer);
+		glNamedBufferStorage(emitter->counterBuffer, CounterBufferSize, counters, 0);
+
+		glCreateBuffers(1, &emitter->parameterBuffer);
+		glNamedBufferStorage(emitter->parameterBuffer, sizeof(Parameters), nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+		// Core profile draws need a vertex array even though every vertex comes from gl_VertexID.
+		glCreateVertexArrays(1, &emitter->vertexArray);
+
+		return emitter;
+	}
+
+	static void DeleteEmitter(void* userData)
+	{
+		Emitter* emitter = static_cast<Emitter*>(userData);
+
+		for (uint32_t program : { emitter->prepareProgram, emitter->simulateProgram, emitter->emitProgram, emitter->finalizeProgram, emitter->renderProgram })
+		{
+			Renderer::DeleteShader(program);
+		}
+
+		glDeleteBuffers(2, emitter->particleBuffers);
+		glDeleteBuffers(1, &emitter->counterBuffer);
+		glDeleteBuffers(1, &emitter->parameterBuffer);
+		glDeleteVertexArrays(1, &emitter->vertexArray);
+
+		delete emitter;
+	}
+
+	void DestroyEmitter(Emitter* emitter)
+	{
+		if (FramePipeline::IsRunning())
+		{
+			CommandBuffer::Get().Call(DeleteEmitter, emitter);
+		}
+		else
+		{
+			DeleteEmitter(emitter);
+		}
+	}
+
+	bool IsReady(Emitter* emitter)
+	{
+		for (uint32_t program : { emitter->prepareProgram, emitter->simulateProgram, emitter->emitProgram, emitter->finalizeProgram, emitter->renderProgram })
+		{
+			if (Renderer::GetShaderStatus(program) != Renderer::ShaderLinked)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	static void RunSimulation(void* userData)
+	{
+		Emitter* emitter = static_cast<Emitter*>(userData);
+
+		glBindBufferBase(GL_UNIFORM_BUFFER, 0, emitter->parameterBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, emitter->particleBuffers[emitter->source]);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, emitter->particleBuffers[emitter->source ^ 1]);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, emitter->counterBuffer);
+		glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, emitter->counterBuffer);
+
+		glUseProgram(emitter->prepareProgram);
+		glDispatchCompute(1, 1, 1);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+
+		glUseProgram(emitter->simulateProgram);
+		glDispatchComputeIndirect(SimulateDispatchOffset);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+		glUseProgram(emitter->emitProgram);
+		glDispatchComputeIndirect(EmitDispatchOffset);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+		glUseProgram(emitter->finalizeProgram);
+		glDispatchCompute(1, 1, 1);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+
+		glUseProgram(0);
+		glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, 0);
+
+		emitter->source ^= 1;
+	}
+
+	static void RunDraw(void* userData)
+	{
+		Emitter* emitter = static_cast<Emitter*>(userData);
+
+		uint32_t textureID = emitter->textureID.load();
+
+		glUseProgram(emitter->renderProgram);
+		glProgramUniform1i(emitter->renderProgram, glGetUniformLocation(emitter->renderProgram, "u_Textured"), textureID != 0);
+
+		glBindBufferBase(GL_UNIFORM_BUFFER, 0, emitter->parameterBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, emitter->particleBuffers[emitter->source]);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, emitter->counterBuffer);
+
+		glBindTexture(GL_TEXTURE_2D, textureID);
+		glBindVertexArray(emitter->vertexArray);
+
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		glDepthMask(GL_FALSE);
+
+		glDrawArraysIndirect(GL_TRIANGLES, reinterpret_cast<void*>(DrawOffset));
+
+		glDepthMask(GL_TRUE);
+		glDisable(GL_BLEND);
+
+		glBindVertexArray(0);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+		glUseProgram(0);
+	}
+
+	void Simulate(Emitter* emitter, const Parameters& parameters)
+	{
+		// The upload is copied into the command stream, so pipelined frames each keep their own parameters.
+		CommandBuffer::Get().UploadBuffer(GL_UNIFORM_BUFFER, emitter->parameterBuffer, 0, &parameters, sizeof(Parameters));
+		CommandBuffer::Get().Call(RunSimulation, emitter);
+	}
+
+	void Draw(Emitter* emitter, const float* projection, const float* view, uint32_t textureID)
+	{
+		emitter->textureID.store(textureID);
+
+		CommandBuffer::Get().SetUniformMat4(emitter->renderProgram, "u_Projection", projection);
+		CommandBuffer::Get().SetUniformMat4(emitter->renderProgram, "u_View", view);
+		CommandBuffer::Get().Call(RunDraw, emitter);
+	}
+}
\ No newline at end of file
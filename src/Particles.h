@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Types.h"
+
+namespace Velkro::Particles
+{
+	// Per frame emitter parameters, laid out like the std140 block the compute and render shaders read.
+	struct Parameters
+	{
+		float position[4]; // w is the frame's delta time.
+		float positionSpread[4];
+		float velocity[4]; // w is the lifetime.
+		float velocitySpread[4]; // w is the lifetime spread.
+		float gravity[4];
+		float startColour[4];
+		float endColour[4];
+		float sizes[4]; // Start and end size.
+
+		uint32_t emitCount;
+		uint32_t capacity;
+		uint32_t seed;
+		uint32_t padding;
+	};
+
+	struct Emitter;
+
+	// Particle state only ever lives in GPU buffers. Every frame a compute pass ages and moves the live particles and
+	// compacts the survivors into the other buffer, a second one appends new particles behind them, and the draw takes its
+	// instance count from a buffer the compute passes wrote. The CPU never reads anything back.
+	Emitter* CreateEmitter(uint32_t capacity);
+	void DestroyEmitter(Emitter* emitter); // Deferred to the context thread while the frame pipeline runs.
+
+	bool IsReady(Emitter* emitter); // False while the programs are still compiling.
+
+	// Both record commands, so they are used from OnUpdate like any other draw.
+	void Simulate(Emitter* emitter, const Parameters& parameters);
+	void Draw(Emitter* emitter, const float* projection, const float* view, uint32_t textureID); // A texture ID of 0 draws soft round particles.
+}
\ No newline at end of file
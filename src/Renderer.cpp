@@ -4,7 +4,14 @@
 #include <GLFW/glfw3.h>
 #include <stb_image.h>
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include "IO.h"
+#include "Cooked.h"
+#include "FramePipeline.h"
+#include "CommandBuffer.h"
 
 namespace Velkro::Renderer
 {
@@ -20,82 +27,156 @@ namespace Velkro::Renderer
 
 		glEnable(GL_BLEND);
 		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+		stbi_set_flip_vertically_on_load(true);
+
+		InitializeStreaming();
+		InitializeShaderCompiler();
 	}
 
-	uint32_t LoadShaderFromFile(const char* vertexShaderFilePath, const char* fragShaderFilePath)
+	uint32_t LoadShaderFromFile(const char* vertexShaderFilePath, const char* fragShaderFilePath, const std::vector<std::string>& defines)
 	{
+		if (FramePipeline::IsRunning())
+		{
+			VLK_CORE_ERROR("Shader \"{}\" loaded while the frame pipeline owns the GL context, load it before the pipeline starts.", vertexShaderFilePath);
+
+			return 0;
+		}
+
 		std::string vertexShaderSourceStr = IO::GetFile(vertexShaderFilePath);
 		std::string fragmentShaderSourceStr = IO::GetFile(fragShaderFilePath);
 
-		const char* vertexShaderSource = vertexShaderSourceStr.c_str();
-		const char* fragmentShaderSource = fragmentShaderSourceStr.c_str();
+		if (vertexShaderSourceStr.empty() || fragmentShaderSourceStr.empty())
+		{
+			return 0;
+		}
 
-		uint32_t vertexShader;
-		vertexShader = glCreateShader(GL_VERTEX_SHADER);
-		
-		glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-		glCompileShader(vertexShader);
+		return LoadShaderFromSource(vertexShaderSourceStr.c_str(), fragmentShaderSourceStr.c_str(), defines);
+	}
+
+	uint32_t LoadCookedShader(const char* path, const std::vector<std::string>& defines)
+	{
+		if (FramePipeline::IsRunning())
+		{
+			VLK_CORE_ERROR("Shader \"{}\" loaded while the frame pipeline owns the GL context, load it before the pipeline starts.", path);
 
-		GLint vertexShaderSuccess;
-		GLchar vertexShaderInfoLog[512];
+			return 0;
+		}
 
-		glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &vertexShaderSuccess);
+		IO::FileView file = IO::MapFile(path);
+		std::span<const uint8_t> blob = file.GetData();
 
-		if (!vertexShaderSuccess)
+		Cooked::ShaderHeader header;
+
+		if (blob.size() < sizeof(header))
 		{
-			glGetShaderInfoLog(vertexShader, 512, NULL, vertexShaderInfoLog);
+			VLK_CORE_ERROR("Cooked shader \"{}\" is truncated.", path);
 
-			VLK_CORE_ERROR("Vertex Shader compilation failed! \n{}\n", vertexShaderInfoLog);
+			return 0;
 		}
 
-		uint32_t fragmentShader;
-		fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+		std::memcpy(&header, blob.data(), sizeof(header));
 
-		glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-		glCompileShader(fragmentShader);
-
-		GLint fragmentShaderSuccess;
-		GLchar fragmentShaderInfoLog[512];
+		if (header.magic != Cooked::ShaderMagic || header.version != Cooked::Version)
+		{
+			VLK_CORE_ERROR("\"{}\" isn't a cooked shader of version {}, cook it again with VelkroCook.", path, Cooked::Version);
 
-		glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &fragmentShaderSuccess);
+			return 0;
+		}
 
-		if (!fragmentShaderSuccess)
+		if (blob.size() < sizeof(header) + header.vertexSize + header.fragmentSize || header.vertexSize == 0 || header.fragmentSize == 0)
 		{
-			glGetShaderInfoLog(vertexShader, 512, NULL, fragmentShaderInfoLog);
+			VLK_CORE_ERROR("Cooked shader \"{}\" is truncated.", path);
 
-			VLK_CORE_ERROR("Fragment Shader compilation failed! \n{}\n", fragmentShaderInfoLog);
+			return 0;
 		}
 
-		uint32_t shaderProgram;
-		shaderProgram = glCreateProgram();
+		const char* vertexShaderSource = reinterpret_cast<const char*>(blob.data() + sizeof(header));
+		const char* fragmentShaderSource = vertexShaderSource + header.vertexSize;
 
-		glAttachShader(shaderProgram, vertexShader);
-		glAttachShader(shaderProgram, fragmentShader);
-		glLinkProgram(shaderProgram);
+		return LoadShaderFromSource(vertexShaderSource, fragmentShaderSource, defines);
+	}
 
-		GLint shaderSuccess;
-		GLchar shaderInfoLog[512];
+	uint32_t CreateTexture2D(const Image::ImageData& image, const Sampler& sampler)
+	{
+		int levelCount = static_cast<int>(image.levels.size());
+		bool generateMipmaps = false;
 
-		glGetProgramiv(shaderProgram, GL_LINK_STATUS, &shaderSuccess);
+		if (!sampler.mipmaps)
+		{
+			levelCount = 1;
+		}
+		else if (levelCount == 1 && !image.compressed)
+		{
+			levelCount = Image::GetMipLevelCount(image.width, image.height);
+			generateMipmaps = true;
+		}
 
-		if (!shaderSuccess)
+		uint32_t textureID;
+
+		glCreateTextures(GL_TEXTURE_2D, 1, &textureID);
+		glTextureStorage2D(textureID, levelCount, image.internalFormat, image.width, image.height);
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+		for (int i = 0; i < static_cast<int>(image.levels.size()) && i < levelCount; i++)
 		{
-			glGetProgramInfoLog(shaderProgram, 512, NULL, shaderInfoLog);
+			const Image::ImageData::Level& level = image.levels[i];
+
+			if (image.compressed)
+			{
+				glCompressedTextureSubImage2D(textureID, i, 0, 0, level.width, level.height, image.internalFormat, static_cast<GLsizei>(level.size), image.GetPixels() + level.offset);
+			}
+			else
+			{
+				glTextureSubImage2D(textureID, i, 0, 0, level.width, level.height, image.format, GL_UNSIGNED_BYTE, image.GetPixels() + level.offset);
+			}
+		}
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
-			VLK_CORE_ERROR("Shader compilation failed! \n{}\n", shaderInfoLog);
+		if (generateMipmaps)
+		{
+			glGenerateTextureMipmap(textureID);
 		}
 
-		glDeleteShader(vertexShader);
-		glDeleteShader(fragmentShader);
+		ApplySampler(textureID, sampler, levelCount);
 
-		return shaderProgram;
+		return textureID;
 	}
 
-	uint32_t LoadTexture2D(const char* path, int& width, int& height, int& channels, bool linear)
+	uint32_t LoadTexture2D(const char* path, int& width, int& height, int& channels, const Sampler& sampler)
 	{
+		if (FramePipeline::IsRunning())
+		{
+			VLK_CORE_ERROR("Texture \"{}\" loaded while the frame pipeline owns the GL context, load it before the pipeline starts.", path);
+
+			return 0;
+		}
+
+		Image::ImageData image;
+
+		if (Image::IsContainer(path))
+		{
+			if (!Image::LoadContainer(path, image))
+			{
+				VLK_CORE_ERROR("Failed to load texture \"{}\", returning empty texture id.", path);
+
+				return 0;
+			}
+
+			width = image.width;
+			height = image.height;
+			channels = 4;
+
+			return CreateTexture2D(image, sampler);
+		}
+
+		IO::FileView file = IO::MapFile(path);
+
 		stbi_set_flip_vertically_on_load(true);
 		
-		uint8_t* pixels = stbi_load(path, &width, &height, &channels, STBI_rgb_alpha);
+		uint8_t* pixels = file.IsOpen() ? stbi_load_from_memory(file.GetPointer(), static_cast<int>(file.GetSize()), &width, &height, &channels, STBI_rgb_alpha) : nullptr;
 		
 		if (!pixels)
 		{
@@ -104,31 +185,70 @@ namespace Velkro::Renderer
 			return 0;
 		}
 
-		uint32_t textureID;
-		
-		glCreateTextures(GL_TEXTURE_2D, 1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-		
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, linear ? GL_LINEAR : GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, linear ? GL_LINEAR : GL_NEAREST);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
-
-		glBindTexture(GL_TEXTURE_2D, 0);
+		image.internalFormat = GL_RGBA8;
+		image.format = GL_RGBA;
+		image.width = width;
+		image.height = height;
+		image.levels.push_back({ 0, static_cast<size_t>(width) * height * 4, width, height });
+		image.pixels.assign(pixels, pixels + image.levels[0].size);
 
 		stbi_image_free(pixels);
 
-		return textureID;
+		return CreateTexture2D(image, sampler);
+	}
+
+	static GLint GetFilter(Sampler::Filter filter, Sampler::Filter mipFilter, bool mipmapped)
+	{
+		if (!mipmapped)
+		{
+			return filter == Sampler::Linear ? GL_LINEAR : GL_NEAREST;
+		}
+
+		if (filter == Sampler::Linear)
+		{
+			return mipFilter == Sampler::Linear ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR_MIPMAP_NEAREST;
+		}
+
+		return mipFilter == Sampler::Linear ? GL_NEAREST_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST;
+	}
+
+	static GLint GetWrap(Sampler::Wrap wrap)
+	{
+		switch (wrap)
+		{
+		case Sampler::MirroredRepeat: return GL_MIRRORED_REPEAT;
+		case Sampler::ClampToEdge: return GL_CLAMP_TO_EDGE;
+		default: return GL_REPEAT;
+		}
+	}
+
+	void ApplySampler(uint32_t textureID, const Sampler& sampler, int levelCount)
+	{
+		static float maxAnisotropy = 0.0f;
+
+		if (maxAnisotropy == 0.0f)
+		{
+			glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &maxAnisotropy);
+
+			maxAnisotropy = std::max(maxAnisotropy, 1.0f);
+		}
+
+		glTextureParameteri(textureID, GL_TEXTURE_MIN_FILTER, GetFilter(sampler.minFilter, sampler.mipFilter, levelCount > 1));
+		glTextureParameteri(textureID, GL_TEXTURE_MAG_FILTER, sampler.magFilter == Sampler::Linear ? GL_LINEAR : GL_NEAREST);
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_S, GetWrap(sampler.wrapS));
+		glTextureParameteri(textureID, GL_TEXTURE_WRAP_T, GetWrap(sampler.wrapT));
+		glTextureParameteri(textureID, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+		glTextureParameterf(textureID, GL_TEXTURE_MAX_ANISOTROPY, std::clamp(sampler.anisotropy, 1.0f, maxAnisotropy));
 	}
 
 	void ClearBuffer()
 	{
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		CommandBuffer::Get().Clear();
 	}
 
 	void UpdateViewport(int x, int y, int width, int height)
 	{
-		glViewport(x, y, width, height);
+		CommandBuffer::Get().SetViewport(x, y, width, height);
 	}
 }
\ No newline at end of file
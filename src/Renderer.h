@@ -1,14 +1,56 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "Types.h"
+#include "Sampler.h"
+#include "Image.h"
 
 namespace Velkro::Renderer
 {
+	typedef void (*TextureLoadedFunction)(void* userData, uint32_t textureID, int width, int height, int channels);
+
 	void Initialize();
 
-	uint32_t LoadShaderFromFile(const char* vertexShaderFilePath, const char* fragShaderFilePath);
+	enum ShaderStatus
+	{
+		ShaderCompiling, ShaderLinked, ShaderFailed
+	};
+
+	// Shader loads only submit the compile and link and return the program straight away, the driver works on them in parallel
+	// when GL_KHR_parallel_shader_compile is available. Poll GetShaderStatus before drawing with the program.
+	// Defines are injected after the #version line as "#define NAME" or, for "NAME=VALUE", "#define NAME VALUE".
+	uint32_t LoadShaderFromFile(const char* vertexShaderFilePath, const char* fragShaderFilePath, const std::vector<std::string>& defines = {});
+	uint32_t LoadCookedShader(const char* path, const std::vector<std::string>& defines = {}); // Both stages from a .vshd blob written by VelkroCook.
+	uint32_t LoadShaderFromSource(const char* vertexShaderSource, const char* fragmentShaderSource, const std::vector<std::string>& defines = {});
+	uint32_t LoadComputeShaderFromSource(const char* computeShaderSource, const std::vector<std::string>& defines = {});
+
+	ShaderStatus GetShaderStatus(uint32_t programID);
+	void DeleteShader(uint32_t programID); // Context thread only.
+
+	void InitializeShaderCompiler();
+	void UpdateShaders(); // Called by the engine once per frame, polls pending programs on the context thread.
+
+	// Every combination of the given features, for submitting all permutations of a shader up front.
+	std::vector<std::vector<std::string>> GetShaderPermutations(const std::vector<std::string>& features);
+
+	// DDS files and cooked .vtex blobs are uploaded as stored, including block compressed formats and their mip chains, anything else goes through stb.
+	uint32_t LoadTexture2D(const char* path, int& width, int& height, int& channels, const Sampler& sampler);
+	uint32_t CreateTexture2D(const Image::ImageData& image, const Sampler& sampler); // Generates missing mipmaps for uncompressed images.
+
+	// Decodes on a job thread and uploads through a pixel buffer over the following frames, onLoaded is called on the main thread once the texture is usable,
+	// or with a texture ID of 0 if it failed to load. Cancelled requests don't call it.
+	uint32_t LoadTexture2DAsync(const char* path, const Sampler& sampler, TextureLoadedFunction onLoaded, void* userData);
+	void CancelTexture2DAsync(uint32_t requestID);
+
+	void InitializeStreaming();
+	void UpdateStreaming(); // Called by the engine once per frame.
+	void SetStreamingBudget(double milliseconds);
+
+	uint32_t GetPlaceholderTexture2D();
 
-	uint32_t LoadTexture2D(const char* path, int& width, int& height, int& channels, bool linear);
+	void ApplySampler(uint32_t textureID, const Sampler& sampler, int levelCount);
 
 	void ClearBuffer();
 
@@ -0,0 +1,41 @@
+#pragma once
+
+namespace Velkro
+{
+	// Describes how a texture is filtered and wrapped, mipmaps are generated on load unless the file already has them.
+	struct Sampler
+	{
+		enum Filter
+		{
+			Nearest, Linear
+		};
+
+		enum Wrap
+		{
+			Repeat, MirroredRepeat, ClampToEdge
+		};
+
+		Filter minFilter = Linear;
+		Filter magFilter = Linear;
+		Filter mipFilter = Linear;
+
+		Wrap wrapS = Repeat;
+		Wrap wrapT = Repeat;
+
+		bool mipmaps = true;
+
+		float anisotropy = 1.0f; // Clamped to what the driver supports.
+
+		// Matches the old linear/nearest flag, without mipmaps.
+		static Sampler FromLinear(bool linear)
+		{
+			Sampler sampler;
+
+			sampler.minFilter = linear ? Linear : Nearest;
+			sampler.magFilter = linear ? Linear : Nearest;
+			sampler.mipmaps = false;
+
+			return sampler;
+		}
+	};
+}
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "ShaderCache.h"
+
+#include <glad/glad.h>
+
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <vector>
+
+#include "IO.h"
+#include "Log.h"
+
+namespace Velkro::ShaderCache
+{
+	struct EntryHeader
+	{
+		uint32_t magic = 0x42505356; // "VSPB"
+		uint32_t format;
+		uint64_t key;
+		uint32_t size;
+	};
+
+	static std::string Directory = ".velkro/shadercache";
+	static bool Enabled = true;
+
+	static int Available = -1; // Unknown until the first query with a context.
+
+	static uint64_t HashDriver = 0;
+
+	static uint64_t Hash(uint64_t hash, const char* data, size_t size)
+	{
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= static_cast<uint8_t>(data[i]);
+			hash *= 0x100000001B3ull;
+		}
+
+		return hash;
+	}
+
+	static uint64_t Hash(uint64_t hash, const char* string)
+	{
+		// The terminator is hashed too, so moving text between the two stages changes the key.
+		return Hash(hash, string ? string : "", string ? std::strlen(string) + 1 : 1);
+	}
+
+	static std::string GetEntryPath(uint64_t key)
+	{
+		return std::format("{}/{:016x}.bin", Directory, key);
+	}
+
+	void SetDirectory(const char* directory)
+	{
+		Directory = directory;
+	}
+
+	void SetEnabled(bool enabled)
+	{
+		Enabled = enabled;
+	}
+
+	bool IsAvailable()
+	{
+		if (!Enabled)
+		{
+			return false;
+		}
+
+		if (Available == -1)
+		{
+			GLint formatCount = 0;
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+
+			Available = formatCount > 0;
+
+			HashDriver = 0xCBF29CE484222325ull;
+			HashDriver = Hash(HashDriver, reinterpret_cast<const char*>(glGetString(GL_VENDOR)));
+			HashDriver = Hash(HashDriver, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+			HashDriver = Hash(HashDriver, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+
+			if (!Available)
+			{
+				VLK_CORE_WARN("ShaderCache: Driver has no program binary formats, shaders are compiled every launch.");
+			}
+		}
+
+		return Available == 1;
+	}
+
+	uint64_t GetKey(const char* vertexShaderSource, const char* fragmentShaderSource)
+	{
+		IsAvailable();
+
+		return Hash(Hash(HashDriver, vertexShaderSource), fragmentShaderSource);
+	}
+
+	// Closed first, mapped files can't be removed on Windows. A cache directory that can't be written just keeps the entry.
+	static void RemoveEntry(IO::FileView& file, const std::string& path)
+	{
+		file.Close();
+
+		std::error_code error;
+		std::filesystem::remove(path, error);
+	}
+
+	uint32_t Load(uint64_t key)
+	{
+		if (!IsAvailable())
+		{
+			return 0;
+		}
+
+		std::string path = GetEntryPath(key);
+
+		IO::FileView file = IO::FileView::OpenLoose(path);
+
+		if (!file.IsOpen())
+		{
+			return 0;
+		}
+
+		EntryHeader header;
+		EntryHeader expected;
+
+		if (file.GetSize() >= sizeof(header))
+		{
+			std::memcpy(&header, file.GetPointer(), sizeof(header));
+		}
+
+		// The size comes from disk, so it is bounded by what the entry actually holds.
+		if (file.GetSize() < sizeof(header) || header.magic != expected.magic || header.key != key || header.size > file.GetSize() - sizeof(header))
+		{
+			RemoveEntry(file, path);
+
+			return 0;
+		}
+
+		uint32_t programID = glCreateProgram();
+
+		glProgramBinary(programID, header.format, file.GetPointer() + sizeof(header), static_cast<GLsizei>(header.size));
+
+		GLint success;
+		glGetProgramiv(programID, GL_LINK_STATUS, &success);
+
+		if (!success)
+		{
+			// Drivers may reject binaries from older builds of themselves even with an unchanged version string.
+			VLK_CORE_DEBUG("ShaderCache: Driver rejected cached program {:016x}, compiling from source.", key);
+
+			glDeleteProgram(programID);
+
+			RemoveEntry(file, path);
+
+			return 0;
+		}
+
+		return programID;
+	}
+
+	void Store(uint64_t key, uint32_t programID)
+	{
+		if (!IsAvailable())
+		{
+			return;
+		}
+
+		GLint size = 0;
+		glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &size);
+
+		if (size <= 0)
+		{
+			return;
+		}
+
+		EntryHeader header;
+		header.key = key;
+
+		std::vector<char> binary(size);
+
+		GLenum format;
+		glGetProgramBinary(programID, size, nullptr, &format, binary.data());
+
+		header.format = format;
+		header.size = static_cast<uint32_t>(size);
+
+		std::error_code error;
+		std::filesystem::create_directories(Directory, error);
+
+		// Written under a temporary name first so a crash never leaves a truncated entry behind.
+		std::string path = GetEntryPath(key);
+		std::string temporaryPath = path + ".tmp";
+
+		{
+			std::ofstream file(temporaryPath, std::ios::binary);
+
+			if (!file.write(reinterpret_cast<const char*>(&header), sizeof(header)) || !file.write(binary.data(), binary.size()))
+			{
+				VLK_CORE_WARN("ShaderCache: Failed to write \"{}\".", temporaryPath);
+
+				return;
+			}
+		}
+
+		std::filesystem::rename(temporaryPath, path, error);
+	}
+
+	void Clear()
+	{
+		std::error_code error;
+		std::filesystem::remove_all(Directory, error);
+	}
+}
\ No newline at end of file
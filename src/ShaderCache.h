@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+
+#include "Types.h"
+
+// On-disk cache of linked program binaries, keyed by a hash of the shader sources and the driver's identity
+// so a driver update or an edited shader simply misses instead of loading a stale binary.
+namespace Velkro::ShaderCache
+{
+	void SetDirectory(const char* directory); // Defaults to ".velkro/shadercache".
+	void SetEnabled(bool enabled);
+
+	bool IsAvailable(); // False if caching is disabled or the driver offers no binary formats. Needs a current context.
+
+	uint64_t GetKey(const char* vertexShaderSource, const char* fragmentShaderSource);
+
+	uint32_t Load(uint64_t key); // Returns a linked program, or 0 if there is no entry or the driver rejected it.
+	void Store(uint64_t key, uint32_t programID); // The program has to be linked with GL_PROGRAM_BINARY_RETRIEVABLE_HINT set.
+
+	void Clear();
+}
\ No newline at end of file
@@ -0,0 +1,362 @@
+#include "Renderer.h"
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ShaderCache.h"
+#include "CommandBuffer.h"
+#include "Log.h"
+
+// Not part of the generated loader, GL_KHR_parallel_shader_compile and its ARB twin share these values.
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace Velkro::Renderer
+{
+	typedef void (APIENTRY* MaxShaderCompilerThreadsFunction)(GLuint count);
+
+	struct PendingProgram
+	{
+		uint32_t programID;
+		uint32_t vertexShader, fragmentShader; // Compute programs keep their shader in vertexShader.
+
+		uint64_t cacheKey;
+	};
+
+	static bool ParallelCompile = false;
+
+	static std::mutex ProgramsMutex;
+	static std::vector<PendingProgram> PendingPrograms; // Only touched on the context thread.
+	static std::unordered_map<uint32_t, ShaderStatus> ProgramStatus; // Programs still compiling or failed, linked ones are removed.
+
+	static std::string InjectDefines(const char* source, const std::vector<std::string>& defines)
+	{
+		if (defines.empty())
+		{
+			return source;
+		}
+
+		std::string result = source;
+
+		size_t insertAt = 0;
+		int line = 1;
+
+		size_t version = result.find("#version");
+
+		if (version != std::string::npos)
+		{
+			insertAt = result.find('\n', version);
+			insertAt = insertAt == std::string::npos ? result.size() : insertAt + 1;
+
+			for (size_t i = 0; i < insertAt; i++)
+			{
+				line += result[i] == '\n';
+			}
+		}
+
+		std::string injected;
+
+		for (const std::string& define : defines)
+		{
+			size_t equals = define.find('=');
+
+			injected += "#define " + (equals == std::string::npos ? define : define.substr(0, equals) + ' ' + define.substr(equals + 1)) + '\n';
+		}
+
+		// Keeps line numbers in driver errors matching the file.
+		injected += "#line " + std::to_string(line) + '\n';
+
+		result.insert(insertAt, injected);
+
+		return result;
+	}
+
+	static void SetStatus(uint32_t programID, ShaderStatus status)
+	{
+		std::lock_guard<std::mutex> lock(ProgramsMutex);
+
+		if (status == ShaderLinked)
+		{
+			ProgramStatus.erase(programID);
+		}
+		else
+		{
+			ProgramStatus[programID] = status;
+		}
+	}
+
+	static void LogShaderErrors(uint32_t shader, const char* stage)
+	{
+		GLint success;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+
+		if (!success)
+		{
+			GLchar infoLog[512];
+			glGetShaderInfoLog(shader, 512, NULL, infoLog);
+
+			VLK_CORE_ERROR("{} Shader compilation failed! \n{}\n", stage, infoLog);
+		}
+	}
+
+	// Runs on the context thread. Without the parallel compile extension the status queries block, but every compile was already
+	// submitted so the driver still gets them as one batch.
+	static void PollPendingPrograms(void* userData)
+	{
+		for (size_t i = 0; i < PendingPrograms.size();)
+		{
+			PendingProgram& program = PendingPrograms[i];
+
+			if (ParallelCompile)
+			{
+				GLint complete;
+				glGetProgramiv(program.programID, GL_COMPLETION_STATUS_KHR, &complete);
+
+				if (!complete)
+				{
+					i++;
+
+					continue;
+				}
+			}
+
+			GLint success;
+			glGetProgramiv(program.programID, GL_LINK_STATUS, &success);
+
+			if (!success)
+			{
+				if (program.fragmentShader)
+				{
+					LogShaderErrors(program.vertexShader, "Vertex");
+					LogShaderErrors(program.fragmentShader, "Fragment");
+				}
+				else
+				{
+					LogShaderErrors(program.vertexShader, "Compute");
+				}
+
+				GLchar infoLog[512];
+				glGetProgramInfoLog(program.programID, 512, NULL, infoLog);
+
+				VLK_CORE_ERROR("Shader compilation failed! \n{}\n", infoLog);
+
+				SetStatus(program.programID, ShaderFailed);
+			}
+			else
+			{
+				ShaderCache::Store(program.cacheKey, program.programID);
+
+				SetStatus(program.programID, ShaderLinked);
+			}
+
+			glDetachShader(program.programID, program.vertexShader);
+			glDeleteShader(program.vertexShader);
+
+			if (program.fragmentShader)
+			{
+				glDetachShader(program.programID, program.fragmentShader);
+				glDeleteShader(program.fragmentShader);
+			}
+
+			program = PendingPrograms.back();
+			PendingPrograms.pop_back();
+		}
+	}
+
+	void InitializeShaderCompiler()
+	{
+		MaxShaderCompilerThreadsFunction maxShaderCompilerThreads = nullptr;
+
+		if (glfwExtensionSupported("GL_KHR_parallel_shader_compile"))
+		{
+			maxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreadsFunction>(glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+		}
+		else if (glfwExtensionSupported("GL_ARB_parallel_shader_compile"))
+		{
+			maxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreadsFunction>(glfwGetProcAddress("glMaxShaderCompilerThreadsARB"));
+		}
+
+		if (maxShaderCompilerThreads)
+		{
+			// Lets the driver pick how many threads to use.
+			maxShaderCompilerThreads(0xFFFFFFFF);
+
+			ParallelCompile = true;
+		}
+		else
+		{
+			VLK_CORE_INFO("Parallel shader compilation isn't supported, shader status is checked once per frame instead.");
+		}
+	}
+
+	uint32_t LoadShaderFromSource(const char* vertexShaderSource, const char* fragmentShaderSource, const std::vector<std::string>& defines)
+	{
+		std::string vertexShaderSourceStr = InjectDefines(vertexShaderSource, defines);
+		std::string fragmentShaderSourceStr = InjectDefines(fragmentShaderSource, defines);
+
+		vertexShaderSource = vertexShaderSourceStr.c_str();
+		fragmentShaderSource = fragmentShaderSourceStr.c_str();
+
+		uint64_t cacheKey = ShaderCache::GetKey(vertexShaderSource, fragmentShaderSource);
+
+		if (uint32_t cachedProgram = ShaderCache::Load(cacheKey))
+		{
+			return cachedProgram;
+		}
+
+		uint32_t vertexShader = glCreateShader(GL_VERTEX_SHADER);
+
+		glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
+		glCompileShader(vertexShader);
+
+		uint32_t fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+
+		glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
+		glCompileShader(fragmentShader);
+
+		// Compile errors are reported by the link status, querying them here would wait for the compile to finish.
+		uint32_t shaderProgram = glCreateProgram();
+
+		glAttachShader(shaderProgram, vertexShader);
+		glAttachShader(shaderProgram, fragmentShader);
+		glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		glLinkProgram(shaderProgram);
+
+		PendingPrograms.push_back({ shaderProgram, vertexShader, fragmentShader, cacheKey });
+
+		SetStatus(shaderProgram, ShaderCompiling);
+
+		return shaderProgram;
+	}
+
+	uint32_t LoadComputeShaderFromSource(const char* computeShaderSource, const std::vector<std::string>& defines)
+	{
+		std::string computeShaderSourceStr = InjectDefines(computeShaderSource, defines);
+
+		computeShaderSource = computeShaderSourceStr.c_str();
+
+		uint64_t cacheKey = ShaderCache::GetKey(computeShaderSource, "compute");
+
+		if (uint32_t cachedProgram = ShaderCache::Load(cacheKey))
+		{
+			return cachedProgram;
+		}
+
+		uint32_t computeShader = glCreateShader(GL_COMPUTE_SHADER);
+
+		glShaderSource(computeShader, 1, &computeShaderSource, NULL);
+		glCompileShader(computeShader);
+
+		uint32_t shaderProgram = glCreateProgram();
+
+		glAttachShader(shaderProgram, computeShader);
+		glProgramParameteri(shaderProgram, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		glLinkProgram(shaderProgram);
+
+		PendingPrograms.push_back({ shaderProgram, computeShader, 0, cacheKey });
+
+		SetStatus(shaderProgram, ShaderCompiling);
+
+		return shaderProgram;
+	}
+
+	ShaderStatus GetShaderStatus(uint32_t programID)
+	{
+		if (programID == 0)
+		{
+			return ShaderFailed;
+		}
+
+		std::lock_guard<std::mutex> lock(ProgramsMutex);
+
+		auto iterator = ProgramStatus.find(programID);
+
+		return iterator == ProgramStatus.end() ? ShaderLinked : iterator->second;
+	}
+
+	void DeleteShader(uint32_t programID)
+	{
+		for (size_t i = 0; i < PendingPrograms.size(); i++)
+		{
+			if (PendingPrograms[i].programID == programID)
+			{
+				glDeleteShader(PendingPrograms[i].vertexShader);
+
+				if (PendingPrograms[i].fragmentShader)
+				{
+					glDeleteShader(PendingPrograms[i].fragmentShader);
+				}
+
+				PendingPrograms[i] = PendingPrograms.back();
+				PendingPrograms.pop_back();
+
+				break;
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(ProgramsMutex);
+
+			ProgramStatus.erase(programID);
+		}
+
+		glDeleteProgram(programID);
+	}
+
+	void UpdateShaders()
+	{
+		bool pending = false;
+
+		{
+			std::lock_guard<std::mutex> lock(ProgramsMutex);
+
+			for (auto& [programID, status] : ProgramStatus)
+			{
+				if (status == ShaderCompiling)
+				{
+					pending = true;
+
+					break;
+				}
+			}
+		}
+
+		if (pending)
+		{
+			CommandBuffer::Get().Call(PollPendingPrograms, nullptr);
+		}
+	}
+
+	std::vector<std::vector<std::string>> GetShaderPermutations(const std::vector<std::string>& features)
+	{
+		std::vector<std::vector<std::string>> permutations;
+
+		if (features.size() > 16)
+		{
+			VLK_CORE_ERROR("{} shader features give too many permutations, split them into smaller sets.", features.size());
+
+			return permutations;
+		}
+
+		for (uint32_t mask = 0; mask < (1u << features.size()); mask++)
+		{
+			std::vector<std::string>& permutation = permutations.emplace_back();
+
+			for (size_t i = 0; i < features.size(); i++)
+			{
+				if (mask & (1u << i))
+				{
+					permutation.push_back(features[i]);
+				}
+			}
+		}
+
+		return permutations;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "SpriteKernels.h"
+
+#include <algorithm>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace Velkro::Sprites
+{
+	static_assert(sizeof(RenderComponent::Vertex) == 8 * sizeof(float), "Kernels store one vertex per 256 bit register.");
+	static_assert(sizeof(UVRect) == 5 * sizeof(float), "Kernels gather UVs with a stride of five floats.");
+
+	static const UVRect WholeTexture = { 0.0f, 0.0f, 1.0f, 1.0f, 0 };
+
+	// Also handles what is left over after the last full group of eight.
+	static void GenerateQuadsScalar(const SpriteArrays& sprites, size_t begin, size_t end, const UVRect* UVs, size_t UVCount, RenderComponent::Vertex* vertices)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			const UVRect& UV = UVs[std::clamp(sprites.textureIDs[i], 0, static_cast<int>(UVCount) - 1)];
+
+			float right = sprites.x[i] + sprites.width[i] * 0.5f;
+			float left = sprites.x[i] - sprites.width[i] * 0.5f;
+			float top = sprites.y[i] + sprites.height[i] * 0.5f;
+			float bottom = sprites.y[i] - sprites.height[i] * 0.5f;
+
+			float z = sprites.z[i];
+			float r = sprites.r[i], g = sprites.g[i], b = sprites.b[i];
+
+			RenderComponent::Vertex* quad = vertices + i * 4;
+
+			quad[0] = { right, top, z, r, g, b, UV.uMax, UV.vMax }; // top right
+			quad[1] = { right, bottom, z, r, g, b, UV.uMax, UV.vMin }; // bottom right
+			quad[2] = { left, bottom, z, r, g, b, UV.uMin, UV.vMin }; // bottom left
+			quad[3] = { left, top, z, r, g, b, UV.uMin, UV.vMax }; // top left
+		}
+	}
+
+#ifdef __AVX2__
+	// Turns eight attribute rows into eight vertices, row i of the result is sprite i.
+	static inline void Transpose(__m256 rows[8])
+	{
+		__m256 t0 = _mm256_unpacklo_ps(rows[0], rows[1]);
+		__m256 t1 = _mm256_unpackhi_ps(rows[0], rows[1]);
+		__m256 t2 = _mm256_unpacklo_ps(rows[2], rows[3]);
+		__m256 t3 = _mm256_unpackhi_ps(rows[2], rows[3]);
+		__m256 t4 = _mm256_unpacklo_ps(rows[4], rows[5]);
+		__m256 t5 = _mm256_unpackhi_ps(rows[4], rows[5]);
+		__m256 t6 = _mm256_unpacklo_ps(rows[6], rows[7]);
+		__m256 t7 = _mm256_unpackhi_ps(rows[6], rows[7]);
+
+		__m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+		__m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+		__m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+		__m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+		__m256 u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+		rows[0] = _mm256_permute2f128_ps(u0, u4, 0x20);
+		rows[1] = _mm256_permute2f128_ps(u1, u5, 0x20);
+		rows[2] = _mm256_permute2f128_ps(u2, u6, 0x20);
+		rows[3] = _mm256_permute2f128_ps(u3, u7, 0x20);
+		rows[4] = _mm256_permute2f128_ps(u0, u4, 0x31);
+		rows[5] = _mm256_permute2f128_ps(u1, u5, 0x31);
+		rows[6] = _mm256_permute2f128_ps(u2, u6, 0x31);
+		rows[7] = _mm256_permute2f128_ps(u3, u7, 0x31);
+	}
+
+	static inline void StoreCorner(RenderComponent::Vertex* vertices, int corner, __m256 x, __m256 y, __m256 z, __m256 r, __m256 g, __m256 b, __m256 u, __m256 v)
+	{
+		__m256 rows[8] = { x, y, z, r, g, b, u, v };
+
+		Transpose(rows);
+
+		float* base = reinterpret_cast<float*>(vertices + corner);
+
+		for (int sprite = 0; sprite < 8; sprite++)
+		{
+			_mm256_storeu_ps(base + sprite * 4 * 8, rows[sprite]);
+		}
+	}
+#endif
+
+	void GenerateQuads(const SpriteArrays& sprites, size_t count, const UVRect* UVs, size_t UVCount, RenderComponent::Vertex* vertices)
+	{
+		if (UVCount == 0)
+		{
+			UVs = &WholeTexture;
+			UVCount = 1;
+		}
+
+		size_t i = 0;
+
+#ifdef __AVX2__
+		const float* UVFloats = reinterpret_cast<const float*>(UVs);
+
+		__m256 half = _mm256_set1_ps(0.5f);
+
+		__m256i minimumID = _mm256_setzero_si256();
+		__m256i maximumID = _mm256_set1_epi32(static_cast<int>(UVCount) - 1);
+
+		for (; i + 8 <= count; i += 8)
+		{
+			__m256 x = _mm256_loadu_ps(sprites.x + i);
+			__m256 y = _mm256_loadu_ps(sprites.y + i);
+			__m256 z = _mm256_loadu_ps(sprites.z + i);
+
+			__m256 halfWidth = _mm256_mul_ps(_mm256_loadu_ps(sprites.width + i), half);
+			__m256 halfHeight = _mm256_mul_ps(_mm256_loadu_ps(sprites.height + i), half);
+
+			__m256 r = _mm256_loadu_ps(sprites.r + i);
+			__m256 g = _mm256_loadu_ps(sprites.g + i);
+			__m256 b = _mm256_loadu_ps(sprites.b + i);
+
+			__m256i IDs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sprites.textureIDs + i));
+			IDs = _mm256_min_epi32(_mm256_max_epi32(IDs, minimumID), maximumID);
+
+			__m256i offsets = _mm256_add_epi32(_mm256_slli_epi32(IDs, 2), IDs); // Five floats per rect.
+
+			__m256 uMin = _mm256_i32gather_ps(UVFloats + 0, offsets, 4);
+			__m256 vMin = _mm256_i32gather_ps(UVFloats + 1, offsets, 4);
+			__m256 uMax = _mm256_i32gather_ps(UVFloats + 2, offsets, 4);
+			__m256 vMax = _mm256_i32gather_ps(UVFloats + 3, offsets, 4);
+
+			__m256 right = _mm256_add_ps(x, halfWidth);
+			__m256 left = _mm256_sub_ps(x, halfWidth);
+			__m256 top = _mm256_add_ps(y, halfHeight);
+			__m256 bottom = _mm256_sub_ps(y, halfHeight);
+
+			RenderComponent::Vertex* quads = vertices + i * 4;
+
+			StoreCorner(quads, 0, right, top, z, r, g, b, uMax, vMax);
+			StoreCorner(quads, 1, right, bottom, z, r, g, b, uMax, vMin);
+			StoreCorner(quads, 2, left, bottom, z, r, g, b, uMin, vMin);
+			StoreCorner(quads, 3, left, top, z, r, g, b, uMin, vMax);
+		}
+#endif
+
+		GenerateQuadsScalar(sprites, i, count, UVs, UVCount, vertices);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "Types.h"
+#include "Component.h"
+#include "AtlasBuilder.h"
+
+namespace Velkro::Sprites
+{
+	// Writes four vertices per sprite in the corner order SpriteComponent uses. Texture IDs are clamped to the UV table,
+	// an empty table maps every sprite to the whole texture. AVX2 builds generate eight sprites per iteration.
+	void GenerateQuads(const SpriteArrays& sprites, size_t count, const UVRect* UVs, size_t UVCount, RenderComponent::Vertex* vertices);
+}
\ No newline at end of file
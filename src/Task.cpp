@@ -0,0 +1,222 @@
+#include "Task.h"
+
+#include <vector>
+#include <unordered_set>
+
+#include "Timer.h"
+
+namespace Velkro
+{
+	namespace Tasks
+	{
+		struct EventWaiter
+		{
+			bool (*match)(Event* event, void* result);
+			void* result;
+			std::coroutine_handle<> handle;
+		};
+
+		struct PollWaiter
+		{
+			bool (*ready)(void* data);
+			void* data;
+			std::coroutine_handle<> handle;
+		};
+
+		static std::vector<std::coroutine_handle<>> FrameWaiters;
+		static std::vector<EventWaiter> EventWaiters;
+		static std::vector<PollWaiter> PollWaiters;
+
+		static std::vector<std::coroutine_handle<>> Resumable; // Tasks whose event arrived, resumed on the next update.
+
+		static std::unordered_set<void*> Roots; // Tasks started with Start, destroying one destroys every task it is awaiting.
+	}
+
+	std::coroutine_handle<> Task::promise_type::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+	{
+		promise_type& promise = handle.promise();
+
+		if (promise.continuation)
+		{
+			return promise.continuation;
+		}
+
+		if (promise.detached)
+		{
+			Tasks::Roots.erase(handle.address());
+
+			handle.destroy();
+		}
+
+		return std::noop_coroutine();
+	}
+
+	Task::Task(std::coroutine_handle<promise_type> handle)
+		: m_Handle(handle)
+	{
+	}
+
+	Task::Task(Task&& other) noexcept
+		: m_Handle(other.m_Handle)
+	{
+		other.m_Handle = nullptr;
+	}
+
+	Task& Task::operator=(Task&& other) noexcept
+	{
+		if (this != &other)
+		{
+			if (m_Handle)
+			{
+				m_Handle.destroy();
+			}
+
+			m_Handle = other.m_Handle;
+			other.m_Handle = nullptr;
+		}
+
+		return *this;
+	}
+
+	Task::~Task()
+	{
+		if (m_Handle)
+		{
+			m_Handle.destroy();
+		}
+	}
+
+	bool Task::IsDone() const
+	{
+		return !m_Handle || m_Handle.done();
+	}
+
+	bool Task::await_ready() const noexcept
+	{
+		return IsDone();
+	}
+
+	std::coroutine_handle<> Task::await_suspend(std::coroutine_handle<> continuation) noexcept
+	{
+		m_Handle.promise().continuation = continuation;
+
+		return m_Handle;
+	}
+
+	namespace Tasks
+	{
+		void Start(Task task)
+		{
+			std::coroutine_handle<Task::promise_type> handle = task.m_Handle;
+
+			if (!handle)
+			{
+				return;
+			}
+
+			task.m_Handle = nullptr;
+
+			handle.promise().detached = true;
+
+			Roots.insert(handle.address());
+
+			handle.resume();
+		}
+
+		void Update()
+		{
+			// Taken before anything resumes, so a task that awaits NextFrame during this update waits for the next one.
+			std::vector<std::coroutine_handle<>> frameWaiters;
+			frameWaiters.swap(FrameWaiters);
+
+			std::vector<std::coroutine_handle<>> resumable;
+			resumable.swap(Resumable);
+
+			for (std::coroutine_handle<> handle : resumable)
+			{
+				handle.resume();
+			}
+
+			for (std::coroutine_handle<> handle : frameWaiters)
+			{
+				handle.resume();
+			}
+
+			std::vector<PollWaiter> pollWaiters;
+			pollWaiters.swap(PollWaiters);
+
+			for (PollWaiter& waiter : pollWaiters)
+			{
+				if (waiter.ready(waiter.data))
+				{
+					waiter.handle.resume();
+				}
+				else
+				{
+					PollWaiters.push_back(waiter);
+				}
+			}
+		}
+
+		void DispatchEvent(Event* event)
+		{
+			for (size_t i = 0; i < EventWaiters.size();)
+			{
+				EventWaiter& waiter = EventWaiters[i];
+
+				if (waiter.match(event, waiter.result))
+				{
+					Resumable.push_back(waiter.handle);
+
+					waiter = EventWaiters.back();
+					EventWaiters.pop_back();
+				}
+				else
+				{
+					i++;
+				}
+			}
+		}
+
+		void Shutdown()
+		{
+			FrameWaiters.clear();
+			EventWaiters.clear();
+			PollWaiters.clear();
+			Resumable.clear();
+
+			std::unordered_set<void*> roots;
+			roots.swap(Roots);
+
+			for (void* root : roots)
+			{
+				std::coroutine_handle<>::from_address(root).destroy();
+			}
+		}
+
+		size_t GetTaskCount()
+		{
+			return Roots.size();
+		}
+
+		void ScheduleFrame(std::coroutine_handle<> handle)
+		{
+			FrameWaiters.push_back(handle);
+		}
+
+		void ScheduleDelay(double seconds, std::coroutine_handle<> handle)
+		{
+			Timers::Schedule(seconds, [](void* address) { std::coroutine_handle<>::from_address(address).resume(); }, handle.address());
+		}
+
+		void ScheduleEvent(bool (*match)(Event* event, void* result), void* result, std::coroutine_handle<> handle)
+		{
+			EventWaiters.push_back({ match, result, handle });
+		}
+
+		void ScheduleUntil(bool (*ready)(void* data), void* data, std::coroutine_handle<> handle)
+		{
+			PollWaiters.push_back({ ready, data, handle });
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+
+#include "Types.h"
+#include "Jobs.h"
+#include "Event.h"
+
+namespace Velkro
+{
+	class Task;
+
+	namespace Tasks
+	{
+		void Start(Task task); // Runs the task until it first suspends, the engine owns it from then on.
+	}
+
+	// Coroutine for logic that spans frames, started with Tasks::Start and resumed by the engine at frame boundaries.
+	class Task
+	{
+	public:
+		struct promise_type
+		{
+			std::coroutine_handle<> continuation;
+
+			bool detached = false;
+
+			Task get_return_object()
+			{
+				return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+			}
+
+			std::suspend_always initial_suspend() noexcept
+			{
+				return {};
+			}
+
+			struct FinalAwaiter
+			{
+				bool await_ready() noexcept
+				{
+					return false;
+				}
+
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept;
+
+				void await_resume() noexcept
+				{
+				}
+			};
+
+			FinalAwaiter final_suspend() noexcept
+			{
+				return {};
+			}
+
+			void return_void()
+			{
+			}
+
+			void unhandled_exception()
+			{
+				std::terminate();
+			}
+		};
+
+		Task() = default;
+		Task(Task&& other) noexcept;
+		Task& operator=(Task&& other) noexcept;
+		~Task();
+
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+
+		bool IsDone() const;
+
+		// Awaiting a task runs it and resumes the caller when it finishes.
+		bool await_ready() const noexcept;
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept;
+		void await_resume() const noexcept
+		{
+		}
+
+	private:
+		explicit Task(std::coroutine_handle<promise_type> handle);
+
+		std::coroutine_handle<promise_type> m_Handle;
+
+		friend void Tasks::Start(Task task);
+	};
+
+	namespace Tasks
+	{
+		void Update(); // Called by the engine once per frame.
+		void DispatchEvent(Event* event);
+		void Shutdown(); // Destroys every task that hasn't finished, delayed tasks are still scheduled as timers so clear those too.
+
+		size_t GetTaskCount();
+
+		// Used by the awaitables below to park a suspended task until it should resume.
+		void ScheduleFrame(std::coroutine_handle<> handle);
+		void ScheduleDelay(double seconds, std::coroutine_handle<> handle);
+		void ScheduleEvent(bool (*match)(Event* event, void* result), void* result, std::coroutine_handle<> handle);
+		void ScheduleUntil(bool (*ready)(void* data), void* data, std::coroutine_handle<> handle);
+
+		struct NextFrame
+		{
+			bool await_ready() const noexcept
+			{
+				return false;
+			}
+			void await_suspend(std::coroutine_handle<> handle) const
+			{
+				ScheduleFrame(handle);
+			}
+			void await_resume() const noexcept
+			{
+			}
+		};
+
+		struct Delay
+		{
+			Delay(double seconds)
+				: seconds(seconds)
+			{
+			}
+
+			double seconds;
+
+			bool await_ready() const noexcept
+			{
+				return seconds <= 0.0;
+			}
+			void await_suspend(std::coroutine_handle<> handle) const
+			{
+				ScheduleDelay(seconds, handle);
+			}
+			void await_resume() const noexcept
+			{
+			}
+		};
+
+		// Resumes with a copy of the next event of type EventType.
+		template<typename EventType>
+		struct WaitForEvent
+		{
+			EventType event;
+
+			bool await_ready() const noexcept
+			{
+				return false;
+			}
+			void await_suspend(std::coroutine_handle<> handle)
+			{
+				ScheduleEvent([](Event* event, void* result)
+				{
+					if (EventType* typedEvent = event->Get<EventType>())
+					{
+						*static_cast<EventType*>(result) = *typedEvent;
+
+						return true;
+					}
+
+					return false;
+				}, &event, handle);
+			}
+			EventType await_resume() const noexcept
+			{
+				return event;
+			}
+		};
+
+		struct WaitForJob
+		{
+			WaitForJob(JobHandle job)
+				: job(std::move(job))
+			{
+			}
+
+			JobHandle job;
+
+			bool await_ready() const noexcept
+			{
+				return job.IsDone();
+			}
+			void await_suspend(std::coroutine_handle<> handle)
+			{
+				ScheduleUntil([](void* data) { return static_cast<JobHandle*>(data)->IsDone(); }, &job, handle);
+			}
+			void await_resume() const noexcept
+			{
+			}
+		};
+
+		// Resumes once asset->IsLoaded() returns true.
+		template<typename Asset>
+		struct WaitForLoad
+		{
+			WaitForLoad(Asset* asset)
+				: asset(asset)
+			{
+			}
+
+			Asset* asset;
+
+			bool await_ready() const noexcept
+			{
+				return asset->IsLoaded();
+			}
+			void await_suspend(std::coroutine_handle<> handle)
+			{
+				ScheduleUntil([](void* data) { return static_cast<Asset*>(data)->IsLoaded(); }, asset, handle);
+			}
+			void await_resume() const noexcept
+			{
+			}
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,356 @@
+#include "Renderer.h"
+
+#include <glad/glad.h>
+#include <stb_image.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Jobs.h"
+#include "IO.h"
+#include "CommandBuffer.h"
+#include "Log.h"
+
+namespace Velkro::Renderer
+{
+	enum StreamState
+	{
+		Decoding, Decoded, Uploaded, Failed
+	};
+
+	struct StreamRequest
+	{
+		uint32_t ID;
+
+		std::string path;
+		Sampler sampler;
+
+		TextureLoadedFunction onLoaded;
+		void* userData;
+
+		std::atomic<int> state = Decoding;
+		std::atomic<bool> cancelled = false;
+
+		uint8_t* pixels = nullptr;
+		int width = 0, height = 0, channels = 0;
+
+		// DDS files and cooked textures are read here instead and uploaded in one go, they need no decoding.
+		Image::ImageData image;
+		bool container = false;
+
+		// Only touched by the GL thread until the request is uploaded.
+		uint32_t textureID = 0;
+		int uploadedRows = 0;
+	};
+
+	// Staging memory is split into one region per frame in flight, each guarded by a fence so it is only reused once the GPU has read it.
+	static constexpr int StagingRegionCount = 3;
+	static constexpr size_t StagingRegionSize = 4 * 1024 * 1024;
+
+	static std::mutex RequestsMutex;
+	static std::vector<std::shared_ptr<StreamRequest>> Requests;
+
+	static uint32_t NextRequestID = 1;
+
+	static double UploadBudget = 2.0; // Milliseconds of upload work per frame.
+
+	static uint32_t StagingBuffer = 0;
+	static uint8_t* StagingMemory = nullptr;
+	static GLsync StagingFences[StagingRegionCount];
+	static int StagingRegion = 0;
+
+	static uint32_t PlaceholderTexture = 0;
+
+	static void CreateStagingBuffer()
+	{
+		glCreateBuffers(1, &StagingBuffer);
+		glNamedBufferStorage(StagingBuffer, StagingRegionCount * StagingRegionSize, nullptr, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT);
+
+		StagingMemory = static_cast<uint8_t*>(glMapNamedBufferRange(StagingBuffer, 0, StagingRegionCount * StagingRegionSize, GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT));
+
+		for (GLsync& fence : StagingFences)
+		{
+			fence = nullptr;
+		}
+	}
+
+	// Runs on the GL thread, uploads decoded pixels a few rows at a time until the frame's budget or staging region runs out.
+	static void UploadDecodedTextures(void* userData)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		std::vector<std::shared_ptr<StreamRequest>> decoded;
+
+		{
+			std::lock_guard<std::mutex> lock(RequestsMutex);
+
+			for (std::shared_ptr<StreamRequest>& request : Requests)
+			{
+				if (request->state.load(std::memory_order_acquire) == Decoded)
+				{
+					decoded.push_back(request);
+				}
+			}
+		}
+
+		if (decoded.empty())
+		{
+			return;
+		}
+
+		if (!StagingBuffer)
+		{
+			CreateStagingBuffer();
+		}
+
+		StagingRegion = (StagingRegion + 1) % StagingRegionCount;
+
+		if (GLsync& fence = StagingFences[StagingRegion])
+		{
+			glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+			glDeleteSync(fence);
+
+			fence = nullptr;
+		}
+
+		size_t regionOffset = StagingRegion * StagingRegionSize;
+		size_t regionUsed = 0;
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, StagingBuffer);
+
+		for (std::shared_ptr<StreamRequest>& request : decoded)
+		{
+			if (request->cancelled.load())
+			{
+				stbi_image_free(request->pixels);
+				request->pixels = nullptr;
+
+				request->state.store(Uploaded, std::memory_order_release);
+
+				continue;
+			}
+
+			if (request->container)
+			{
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+				request->textureID = CreateTexture2D(request->image, request->sampler);
+				request->image = Image::ImageData();
+
+				request->state.store(Uploaded, std::memory_order_release);
+
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, StagingBuffer);
+
+				continue;
+			}
+
+			int levelCount = request->sampler.mipmaps ? Image::GetMipLevelCount(request->width, request->height) : 1;
+
+			if (!request->textureID)
+			{
+				glCreateTextures(GL_TEXTURE_2D, 1, &request->textureID);
+				glTextureStorage2D(request->textureID, levelCount, GL_RGBA8, request->width, request->height);
+
+				ApplySampler(request->textureID, request->sampler, levelCount);
+			}
+
+			size_t rowSize = static_cast<size_t>(request->width) * 4;
+
+			while (request->uploadedRows < request->height)
+			{
+				int rows = static_cast<int>((StagingRegionSize - regionUsed) / rowSize);
+
+				if (rows == 0)
+				{
+					break;
+				}
+
+				rows = std::min(rows, request->height - request->uploadedRows);
+
+				std::memcpy(StagingMemory + regionOffset + regionUsed, request->pixels + request->uploadedRows * rowSize, rows * rowSize);
+
+				glTextureSubImage2D(request->textureID, 0, 0, request->uploadedRows, request->width, rows, GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast<void*>(regionOffset + regionUsed));
+
+				request->uploadedRows += rows;
+
+				regionUsed += rows * rowSize;
+
+				if (std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() > UploadBudget)
+				{
+					break;
+				}
+			}
+
+			if (request->uploadedRows == request->height)
+			{
+				if (levelCount > 1)
+				{
+					glGenerateTextureMipmap(request->textureID);
+				}
+
+				stbi_image_free(request->pixels);
+				request->pixels = nullptr;
+
+				request->state.store(Uploaded, std::memory_order_release);
+			}
+
+			if (regionUsed + rowSize > StagingRegionSize || std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() > UploadBudget)
+			{
+				break;
+			}
+		}
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+		StagingFences[StagingRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	static void DeleteTexture(void* userData)
+	{
+		uint32_t textureID = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(userData));
+
+		glDeleteTextures(1, &textureID);
+	}
+
+	void InitializeStreaming()
+	{
+		const uint8_t pixels[] = { 255, 0, 255, 255 };
+
+		glCreateTextures(GL_TEXTURE_2D, 1, &PlaceholderTexture);
+		glTextureStorage2D(PlaceholderTexture, 1, GL_RGBA8, 1, 1);
+		glTextureSubImage2D(PlaceholderTexture, 0, 0, 0, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+	}
+
+	uint32_t LoadTexture2DAsync(const char* path, const Sampler& sampler, TextureLoadedFunction onLoaded, void* userData)
+	{
+		std::shared_ptr<StreamRequest> request = std::make_shared<StreamRequest>();
+		request->ID = NextRequestID++;
+		request->path = path;
+		request->sampler = sampler;
+		request->container = Image::IsContainer(path);
+		request->onLoaded = onLoaded;
+		request->userData = userData;
+
+		{
+			std::lock_guard<std::mutex> lock(RequestsMutex);
+
+			Requests.push_back(request);
+		}
+
+		Jobs::Submit([request]()
+		{
+			if (request->container)
+			{
+				bool loaded = Image::LoadContainer(request->path.c_str(), request->image);
+
+				request->width = request->image.width;
+				request->height = request->image.height;
+				request->channels = 4;
+
+				request->state.store(loaded ? Decoded : Failed, std::memory_order_release);
+
+				return;
+			}
+
+			IO::FileView file = IO::MapFile(request->path);
+
+			if (file.IsOpen())
+			{
+				request->pixels = stbi_load_from_memory(file.GetPointer(), static_cast<int>(file.GetSize()), &request->width, &request->height, &request->channels, STBI_rgb_alpha);
+			}
+
+			request->state.store(request->pixels ? Decoded : Failed, std::memory_order_release);
+		});
+
+		return request->ID;
+	}
+
+	void CancelTexture2DAsync(uint32_t requestID)
+	{
+		std::lock_guard<std::mutex> lock(RequestsMutex);
+
+		for (std::shared_ptr<StreamRequest>& request : Requests)
+		{
+			if (request->ID == requestID)
+			{
+				request->cancelled.store(true);
+			}
+		}
+	}
+
+	void UpdateStreaming()
+	{
+		std::vector<std::shared_ptr<StreamRequest>> finished;
+
+		{
+			std::lock_guard<std::mutex> lock(RequestsMutex);
+
+			for (size_t i = 0; i < Requests.size();)
+			{
+				int state = Requests[i]->state.load(std::memory_order_acquire);
+
+				if (state == Uploaded || state == Failed)
+				{
+					finished.push_back(Requests[i]);
+
+					Requests[i] = Requests.back();
+					Requests.pop_back();
+				}
+				else
+				{
+					i++;
+				}
+			}
+		}
+
+		for (std::shared_ptr<StreamRequest>& request : finished)
+		{
+			if (request->state == Failed)
+			{
+				if (!request->cancelled.load())
+				{
+					VLK_CORE_ERROR("Failed to stream texture \"{}\", keeping the placeholder texture.", request->path);
+
+					request->onLoaded(request->userData, 0, 0, 0, 0);
+				}
+
+				continue;
+			}
+
+			if (request->cancelled.load())
+			{
+				if (request->textureID)
+				{
+					CommandBuffer::Get().Call(DeleteTexture, reinterpret_cast<void*>(static_cast<uintptr_t>(request->textureID)));
+				}
+
+				continue;
+			}
+
+			request->onLoaded(request->userData, request->textureID, request->width, request->height, request->channels);
+		}
+
+		// Recorded before the frame's draws so finished uploads can be used next frame.
+		if (!Requests.empty())
+		{
+			CommandBuffer::Get().Call(UploadDecodedTextures, nullptr);
+		}
+	}
+
+	void SetStreamingBudget(double milliseconds)
+	{
+		UploadBudget = milliseconds;
+	}
+
+	uint32_t GetPlaceholderTexture2D()
+	{
+		return PlaceholderTexture;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include "Timer.h"
+
+#include <vector>
+#include <cmath>
+
+#include "Log.h"
+
+namespace Velkro::Timers
+{
+	// 256 ticks on the first level and 64 slots on each level above it, covering 2^26 ticks (18 hours at 1 ms).
+	// Timers further out are parked in the last level and placed again when it cascades.
+	static constexpr int FirstLevelBits = 8;
+	static constexpr int LevelBits = 6;
+	static constexpr int LevelCount = 4;
+
+	static constexpr uint32_t FirstLevelSize = 1 << FirstLevelBits;
+	static constexpr uint32_t LevelSize = 1 << LevelBits;
+	static constexpr uint32_t SlotCount = FirstLevelSize + (LevelCount - 1) * LevelSize;
+	static constexpr uint32_t FiringSlot = SlotCount; // Timers of the tick being processed, so callbacks can still cancel them.
+
+	static constexpr uint64_t MaxDelta = (uint64_t(1) << (FirstLevelBits + (LevelCount - 1) * LevelBits)) - 1;
+
+	static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+	struct Timer
+	{
+		uint64_t expiry;
+
+		uint32_t previous, next;
+		uint32_t slot;
+		uint32_t generation;
+
+		TimerFunction function;
+		void* userData;
+
+		bool pending;
+	};
+
+	static std::vector<Timer> Pool;
+	static uint32_t FreeList = InvalidIndex;
+
+	static uint32_t Slots[SlotCount + 1];
+	static bool SlotsInitialized = false;
+
+	static uint64_t CurrentTick = 0; // Next tick to be processed.
+	static double Resolution = 0.001;
+	static double Time = 0.0;
+
+	static size_t PendingCount = 0;
+
+	static void InitializeSlots()
+	{
+		for (uint32_t& slot : Slots)
+		{
+			slot = InvalidIndex;
+		}
+
+		SlotsInitialized = true;
+	}
+
+	static uint32_t GetSlot(uint64_t expiry)
+	{
+		uint64_t delta = expiry - CurrentTick;
+
+		if (delta < FirstLevelSize)
+		{
+			return static_cast<uint32_t>(expiry & (FirstLevelSize - 1));
+		}
+
+		for (int level = 1; level < LevelCount; level++)
+		{
+			int shift = FirstLevelBits + level * LevelBits;
+
+			if (delta < (uint64_t(1) << shift) || level == LevelCount - 1)
+			{
+				if (delta > MaxDelta)
+				{
+					expiry = CurrentTick + MaxDelta;
+				}
+
+				uint64_t index = (expiry >> (shift - LevelBits)) & (LevelSize - 1);
+
+				return FirstLevelSize + (level - 1) * LevelSize + static_cast<uint32_t>(index);
+			}
+		}
+
+		return 0;
+	}
+
+	static void Link(uint32_t index)
+	{
+		Timer& timer = Pool[index];
+
+		timer.slot = GetSlot(timer.expiry);
+		timer.previous = InvalidIndex;
+		timer.next = Slots[timer.slot];
+
+		if (timer.next != InvalidIndex)
+		{
+			Pool[timer.next].previous = index;
+		}
+
+		Slots[timer.slot] = index;
+	}
+
+	static void Unlink(uint32_t index)
+	{
+		Timer& timer = Pool[index];
+
+		if (timer.previous != InvalidIndex)
+		{
+			Pool[timer.previous].next = timer.next;
+		}
+		else
+		{
+			Slots[timer.slot] = timer.next;
+		}
+
+		if (timer.next != InvalidIndex)
+		{
+			Pool[timer.next].previous = timer.previous;
+		}
+	}
+
+	static void Free(uint32_t index)
+	{
+		Timer& timer = Pool[index];
+
+		timer.pending = false;
+		timer.generation++;
+		timer.next = FreeList;
+
+		FreeList = index;
+
+		PendingCount--;
+	}
+
+	// Moves every timer in a higher level slot down to where it belongs now that it is closer to expiring.
+	static void Cascade(uint32_t slot)
+	{
+		uint32_t index = Slots[slot];
+
+		Slots[slot] = InvalidIndex;
+
+		while (index != InvalidIndex)
+		{
+			uint32_t next = Pool[index].next;
+
+			Link(index);
+
+			index = next;
+		}
+	}
+
+	static void ProcessTick()
+	{
+		uint32_t firstLevelIndex = static_cast<uint32_t>(CurrentTick & (FirstLevelSize - 1));
+
+		if (firstLevelIndex == 0)
+		{
+			for (int level = 1; level < LevelCount; level++)
+			{
+				int shift = FirstLevelBits + (level - 1) * LevelBits;
+
+				uint32_t index = static_cast<uint32_t>((CurrentTick >> shift) & (LevelSize - 1));
+
+				Cascade(FirstLevelSize + (level - 1) * LevelSize + index);
+
+				if (index != 0)
+				{
+					break;
+				}
+			}
+		}
+
+		Slots[FiringSlot] = Slots[firstLevelIndex];
+		Slots[firstLevelIndex] = InvalidIndex;
+
+		for (uint32_t index = Slots[FiringSlot]; index != InvalidIndex; index = Pool[index].next)
+		{
+			Pool[index].slot = FiringSlot;
+		}
+
+		CurrentTick++;
+
+		while (Slots[FiringSlot] != InvalidIndex)
+		{
+			uint32_t index = Slots[FiringSlot];
+
+			TimerFunction function = Pool[index].function;
+			void* userData = Pool[index].userData;
+
+			Unlink(index);
+			Free(index);
+
+			function(userData);
+		}
+	}
+
+	TimerHandle Schedule(double delay, TimerFunction function, void* userData)
+	{
+		if (!SlotsInitialized)
+		{
+			InitializeSlots();
+		}
+
+		uint32_t index;
+
+		if (FreeList != InvalidIndex)
+		{
+			index = FreeList;
+			FreeList = Pool[index].next;
+		}
+		else
+		{
+			index = static_cast<uint32_t>(Pool.size());
+
+			Pool.push_back(Timer());
+			Pool[index].generation = 0;
+		}
+
+		uint64_t ticks = delay > 0.0 ? static_cast<uint64_t>(std::ceil(delay / Resolution)) : 0;
+
+		Timer& timer = Pool[index];
+		timer.expiry = CurrentTick + ticks;
+		timer.function = function;
+		timer.userData = userData;
+		timer.pending = true;
+
+		Link(index);
+
+		PendingCount++;
+
+		return TimerHandle(index, timer.generation);
+	}
+
+	bool Cancel(TimerHandle handle)
+	{
+		if (!IsPending(handle))
+		{
+			return false;
+		}
+
+		Unlink(handle.index);
+		Free(handle.index);
+
+		return true;
+	}
+
+	bool IsPending(TimerHandle handle)
+	{
+		return handle.index < Pool.size() && Pool[handle.index].generation == handle.generation && Pool[handle.index].pending;
+	}
+
+	void Update(double time)
+	{
+		if (!SlotsInitialized)
+		{
+			InitializeSlots();
+		}
+
+		Time = time;
+
+		uint64_t targetTick = static_cast<uint64_t>(time / Resolution);
+
+		while (CurrentTick <= targetTick)
+		{
+			if (PendingCount == 0)
+			{
+				CurrentTick = targetTick + 1;
+
+				break;
+			}
+
+			ProcessTick();
+		}
+	}
+
+	void Clear()
+	{
+		Pool.clear();
+		FreeList = InvalidIndex;
+
+		InitializeSlots();
+
+		PendingCount = 0;
+	}
+
+	void SetResolution(double seconds)
+	{
+		if (PendingCount != 0)
+		{
+			VLK_CORE_ERROR("Timer resolution can't change while {} timers are pending.", PendingCount);
+
+			return;
+		}
+
+		Resolution = seconds;
+		CurrentTick = static_cast<uint64_t>(Time / Resolution);
+	}
+
+	double GetTime()
+	{
+		return Time;
+	}
+
+	size_t GetTimerCount()
+	{
+		return PendingCount;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Types.h"
+
+namespace Velkro
+{
+	struct TimerHandle
+	{
+		uint32_t index = 0xFFFFFFFF;
+		uint32_t generation = 0;
+
+		bool IsValid() const
+		{
+			return index != 0xFFFFFFFF;
+		}
+	};
+
+	typedef void (*TimerFunction)(void* userData);
+
+	// Hierarchical timing wheel, scheduling and cancelling are O(1) no matter how many timers are pending.
+	// Timers fire at frame boundaries from Engine::Run, with a resolution of one tick.
+	namespace Timers
+	{
+		TimerHandle Schedule(double delay, TimerFunction function, void* userData = nullptr);
+		bool Cancel(TimerHandle handle); // Returns false if the timer already fired or was cancelled.
+
+		bool IsPending(TimerHandle handle);
+
+		void Update(double time); // Fires every timer due at or before time.
+		void Clear();
+
+		void SetResolution(double seconds); // Length of a tick, can only be changed while no timers are pending.
+
+		double GetTime();
+		size_t GetTimerCount();
+	}
+}
\ No newline at end of file
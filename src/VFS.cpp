@@ -0,0 +1,217 @@
+#include "IO.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+
+#include "Archive.h"
+#include "LZ4.h"
+
+namespace Velkro::IO
+{
+	struct MountedArchive
+	{
+		std::string path;
+
+		FileView file;
+
+		const Archive::Entry* entries;
+		uint32_t entryCount;
+
+		const char* names;
+	};
+
+	static std::mutex ArchivesMutex;
+	static std::vector<std::shared_ptr<MountedArchive>> Archives; // Newest last, searched back to front.
+
+	static bool LooseFileOverrides = VLK_CONFIG_DEBUG;
+
+	static const Archive::Entry* FindEntry(const MountedArchive& archive, const std::string& normalizedPath)
+	{
+		uint64_t hash = Archive::HashPath(normalizedPath);
+
+		const Archive::Entry* end = archive.entries + archive.entryCount;
+		const Archive::Entry* entry = std::lower_bound(archive.entries, end, hash, [](const Archive::Entry& entry, uint64_t hash) { return entry.hash < hash; });
+
+		for (; entry != end && entry->hash == hash; entry++)
+		{
+			if (std::string_view(archive.names + entry->nameOffset, entry->nameLength) == normalizedPath)
+			{
+				return entry;
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool Mount(const std::string& archivePath)
+	{
+		std::shared_ptr<MountedArchive> archive = std::make_shared<MountedArchive>();
+		archive->path = archivePath;
+		archive->file = FileView::OpenLoose(archivePath);
+
+		if (!archive->file.IsOpen())
+		{
+			VLK_CORE_ERROR("IO: Failed to open archive {0}", archivePath);
+
+			return false;
+		}
+
+		const uint8_t* data = archive->file.GetPointer();
+		size_t size = archive->file.GetSize();
+
+		Archive::Header header;
+
+		if (size < sizeof(header))
+		{
+			VLK_CORE_ERROR("IO: Archive {0} is truncated.", archivePath);
+
+			return false;
+		}
+
+		std::memcpy(&header, data, sizeof(header));
+
+		if (header.magic != Archive::Magic || header.version != Archive::Version)
+		{
+			VLK_CORE_ERROR("IO: {0} isn't an archive of version {1}, pack it again with VelkroCook.", archivePath, Archive::Version);
+
+			return false;
+		}
+
+		if (header.entriesOffset % alignof(Archive::Entry) != 0 || header.entriesOffset + header.entryCount * sizeof(Archive::Entry) > size || header.namesOffset > size)
+		{
+			VLK_CORE_ERROR("IO: Archive {0} has a corrupt table of contents.", archivePath);
+
+			return false;
+		}
+
+		archive->entries = reinterpret_cast<const Archive::Entry*>(data + header.entriesOffset);
+		archive->entryCount = header.entryCount;
+		archive->names = reinterpret_cast<const char*>(data + header.namesOffset);
+
+		for (uint32_t i = 0; i < archive->entryCount; i++)
+		{
+			const Archive::Entry& entry = archive->entries[i];
+
+			// Raw entries are served with their unpacked size, so it has to match what is stored.
+			bool raw = !(entry.flags & Archive::EntryCompressed);
+
+			if (entry.offset > size || entry.storedSize > size - entry.offset || (raw && entry.size != entry.storedSize) || header.namesOffset + entry.nameOffset + entry.nameLength > size)
+			{
+				VLK_CORE_ERROR("IO: Archive {0} has a corrupt entry.", archivePath);
+
+				return false;
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(ArchivesMutex);
+
+		Archives.push_back(archive);
+
+		VLK_CORE_INFO("IO: Mounted {0} with {1} entries.", archivePath, header.entryCount);
+
+		return true;
+	}
+
+	void Unmount(const std::string& archivePath)
+	{
+		std::lock_guard<std::mutex> lock(ArchivesMutex);
+
+		// Views into the archive keep it mapped until they close.
+		std::erase_if(Archives, [&archivePath](const std::shared_ptr<MountedArchive>& archive) { return archive->path == archivePath; });
+	}
+
+	void SetLooseFileOverrides(bool enabled)
+	{
+		LooseFileOverrides = enabled;
+	}
+
+	bool Exists(const std::string& filePath)
+	{
+		std::error_code error;
+
+		if (std::filesystem::exists(filePath, error))
+		{
+			return true;
+		}
+
+		std::string normalizedPath = Archive::NormalizePath(filePath);
+
+		std::lock_guard<std::mutex> lock(ArchivesMutex);
+
+		for (const std::shared_ptr<MountedArchive>& archive : Archives)
+		{
+			if (FindEntry(*archive, normalizedPath))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool OpenFromArchives(const std::string& filePath, FileView& view)
+	{
+		std::shared_ptr<MountedArchive> archive;
+		const Archive::Entry* entry = nullptr;
+
+		{
+			std::lock_guard<std::mutex> lock(ArchivesMutex);
+
+			if (Archives.empty())
+			{
+				return false;
+			}
+
+			std::string normalizedPath = Archive::NormalizePath(filePath);
+
+			for (size_t i = Archives.size(); i-- > 0;)
+			{
+				if ((entry = FindEntry(*Archives[i], normalizedPath)))
+				{
+					archive = Archives[i];
+
+					break;
+				}
+			}
+		}
+
+		if (!entry)
+		{
+			return false;
+		}
+
+		if (LooseFileOverrides)
+		{
+			std::error_code error;
+
+			if (std::filesystem::exists(filePath, error))
+			{
+				return false;
+			}
+		}
+
+		const uint8_t* data = archive->file.GetPointer() + entry->offset;
+
+		if (!(entry->flags & Archive::EntryCompressed))
+		{
+			view = FileView::FromShared(data, entry->size, archive);
+
+			return true;
+		}
+
+		std::vector<uint8_t> buffer(entry->size);
+
+		if (!LZ4::Decompress(data, entry->storedSize, buffer.data(), buffer.size()))
+		{
+			VLK_CORE_ERROR("IO: Entry {0} in archive {1} is corrupt.", filePath, archive->path);
+
+			return false;
+		}
+
+		view = FileView::FromBuffer(std::move(buffer));
+
+		return true;
+	}
+}
\ No newline at end of file
@@ -1,10 +1,19 @@
 #include <unordered_map>
+#include <chrono>
+#include <thread>
+#include <cmath>
 
 #include <Velkro/Velkro.h>
 
 #include "Window.h"
 #include "Log.h"
 #include "UUID.h"
+#include "FramePipeline.h"
+#include "Jobs.h"
+#include "Task.h"
+#include "Timer.h"
+#include "Renderer.h"
+#include "Assets.h"
 
 namespace Velkro
 {
@@ -35,6 +44,17 @@ namespace Velkro
 		std::unordered_map<std::string, Entity*> m_Entities;
 	};
 
+	// Every exit path stops the workers before the entities go away, and the pipeline last so queued GL work still runs.
+	static void StopSubsystems()
+	{
+		Tasks::Shutdown();
+		Timers::Clear();
+		Jobs::Shutdown();
+		Assets::SetHotReload(false);
+
+		FramePipeline::Stop();
+	}
+
 	void Engine::Run(OnEnterFunction onEnterFunction, OnUpdateFunction onUpdateFunction, OnExitFunction onExitFunction, OnEventFunctionEngine onEventFunction)
 	{
 		m_Data = new Data();
@@ -45,6 +65,8 @@ namespace Velkro
 
 		Window::SetEventFunction(OnEvent);
 
+		Jobs::Initialize();
+
 		VLK_CORE_DEBUG("Entering program.");
 
 		int entryExitCode = onEnterFunction();
@@ -62,31 +84,109 @@ namespace Velkro
 			exit(0);
 		}		
 
+		if (m_Pipelined)
+		{
+			FramePipeline::Start();
+		}
+
+		std::chrono::steady_clock::time_point previousFrameTime = std::chrono::steady_clock::now();
+
+		double accumulator = 0.0;
+
 		while (m_Running)
 		{
-			ExitCode updateExitCode = onUpdateFunction();
+			std::chrono::steady_clock::time_point currentFrameTime = std::chrono::steady_clock::now();
+
+			m_FrameTime = std::chrono::duration<double>(currentFrameTime - previousFrameTime).count();
+			m_Time += m_FrameTime;
+
+			previousFrameTime = currentFrameTime;
 
-			if (updateExitCode == Error)
+			int updateCount = 1;
+
+			if (m_FixedTimestep)
 			{
-				VLK_CORE_FATAL("Error in update loop. Exiting program.");
+				double fixedDeltaTime = 1.0 / m_UpdateRate;
 
-				break;
+				accumulator += m_FrameTime;
+
+				updateCount = static_cast<int>(accumulator / fixedDeltaTime);
+
+				// Drop whatever can't be caught up on, otherwise a slow update makes every following frame slower.
+				if (updateCount > m_MaxUpdatesPerFrame)
+				{
+					VLK_CORE_DEBUG("Update loop is {} steps behind, skipping {} steps.", updateCount, updateCount - m_MaxUpdatesPerFrame);
+
+					updateCount = m_MaxUpdatesPerFrame;
+					accumulator = std::fmod(accumulator, fixedDeltaTime);
+				}
+				else
+				{
+					accumulator -= updateCount * fixedDeltaTime;
+				}
+
+				m_DeltaTime = fixedDeltaTime;
 			}
-			else if (updateExitCode == Exit)
+			else
 			{
-				VLK_CORE_DEBUG("Exiting program on update.");
+				m_DeltaTime = m_FrameTime;
+			}
+
+			for (int i = 0; i < updateCount && m_Running; i++)
+			{
+				for (std::pair<std::string, Entity*> entity : m_Data->GetEntities())
+				{
+					entity.second->OnFixedUpdate();
+				}
+
+				ExitCode updateExitCode = onUpdateFunction();
+
+				if (updateExitCode == Error)
+				{
+					VLK_CORE_FATAL("Error in update loop. Exiting program.");
 
+					m_Running = false;
+				}
+				else if (updateExitCode == Exit)
+				{
+					VLK_CORE_DEBUG("Exiting program on update.");
+
+					m_Running = false;
+				}
+			}
+
+			if (!m_Running)
+			{
 				break;
 			}
 
+			Timers::Update(m_Time);
+			Tasks::Update();
+
+			Assets::UpdateHotReload();
+
+			Renderer::UpdateStreaming();
+			Renderer::UpdateShaders();
+
+			m_InterpolationAlpha = m_FixedTimestep ? static_cast<float>(accumulator * m_UpdateRate) : 1.0f;
+
 			for (std::pair<std::string, Entity*> entity : m_Data->GetEntities())
 			{
 				entity.second->OnUpdate();
 			}
 
+			FramePipeline::Submit();
+
 			Window::PollEvents();
+
+			if (m_RenderRate > 0.0)
+			{
+				std::this_thread::sleep_until(currentFrameTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / m_RenderRate)));
+			}
 		}
 
+		StopSubsystems();
+
 		ExitCode exitCode = onExitFunction();
 
 		if (exitCode == Error)
@@ -119,6 +219,61 @@ namespace Velkro
 		m_Data->GetEntities()[entity->GetUUID()] = entity;
 	}
 
+	void Engine::SetFixedTimestep(double updateRate, int maxUpdatesPerFrame)
+	{
+		if (updateRate <= 0.0 || maxUpdatesPerFrame < 1)
+		{
+			VLK_CORE_ERROR("Invalid fixed timestep of {} updates per second and {} updates per frame, ignoring.", updateRate, maxUpdatesPerFrame);
+
+			return;
+		}
+
+		m_FixedTimestep = true;
+
+		m_UpdateRate = updateRate;
+		m_MaxUpdatesPerFrame = maxUpdatesPerFrame;
+	}
+	void Engine::SetVariableTimestep()
+	{
+		m_FixedTimestep = false;
+	}
+	void Engine::SetRenderRate(double renderRate)
+	{
+		m_RenderRate = renderRate;
+	}
+
+	void Engine::SetPipelined(bool pipelined)
+	{
+		m_Pipelined = pipelined;
+	}
+
+	void Engine::SetHotReload(bool hotReload)
+	{
+		Assets::SetHotReload(hotReload);
+	}
+
+	bool Engine::IsFixedTimestep()
+	{
+		return m_FixedTimestep;
+	}
+
+	double Engine::GetTime()
+	{
+		return m_Time;
+	}
+	double Engine::GetDeltaTime()
+	{
+		return m_DeltaTime;
+	}
+	double Engine::GetFrameTime()
+	{
+		return m_FrameTime;
+	}
+	float Engine::GetInterpolationAlpha()
+	{
+		return m_InterpolationAlpha;
+	}
+
 	void Engine::OnEvent(Event* event, const char* windowComponentUUID, const char* entityUUID)
 	{
 		WindowComponent* windowComponent = m_Data->GetEntity(entityUUID)->GetComponent<WindowComponent>(windowComponentUUID);
@@ -131,6 +286,8 @@ namespace Velkro
 
 			delete event;
 
+			StopSubsystems();
+
 			exit(exitCode);
 		}
 		else if (exitCode == Exit)
@@ -139,9 +296,13 @@ namespace Velkro
 
 			delete event;
 
+			StopSubsystems();
+
 			exit(0);
 		}
 
+		Tasks::DispatchEvent(event);
+
 		for (std::pair<std::string, Entity*> entity : m_Data->GetEntities())
 		{
 			entity.second->OnEvent(event, windowComponent);
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "Types.h"
+
+namespace Velkro
+{
+	// GL type enums, kept here so the public headers don't need glad.
+	namespace AttributeTypes
+	{
+		static constexpr uint32_t UnsignedByte = 0x1401;
+		static constexpr uint32_t UnsignedShort = 0x1403;
+		static constexpr uint32_t Float = 0x1406;
+		static constexpr uint32_t HalfFloat = 0x140B;
+	}
+
+	struct AttributeDescription
+	{
+		uint32_t type;
+		int count;
+		bool normalized;
+		size_t offset;
+	};
+
+	template<uint32_t Type, int Count, bool Normalized = false>
+	struct VertexAttribute
+	{
+		static constexpr uint32_t type = Type;
+		static constexpr int count = Count;
+		static constexpr bool normalized = Normalized;
+
+		static constexpr size_t size = Count * (Type == AttributeTypes::Float ? 4 : Type == AttributeTypes::UnsignedByte ? 1 : 2);
+	};
+
+	using Float2 = VertexAttribute<AttributeTypes::Float, 2>;
+	using Float3 = VertexAttribute<AttributeTypes::Float, 3>;
+	using Half4 = VertexAttribute<AttributeTypes::HalfFloat, 4>;
+	using UNorm8x4 = VertexAttribute<AttributeTypes::UnsignedByte, 4, true>;
+	using UNorm16x2 = VertexAttribute<AttributeTypes::UnsignedShort, 2, true>;
+
+	// Attribute list of a vertex type, in shader location order. Offsets and the stride are worked out at compile time
+	// and the VAO is set up from them, so a layout is just a struct plus this list.
+	template<typename... Attributes>
+	struct VertexAttributes
+	{
+		static constexpr size_t count = sizeof...(Attributes);
+		static constexpr size_t stride = (Attributes::size + ...);
+
+		static constexpr std::array<AttributeDescription, count> descriptions = []()
+		{
+			std::array<AttributeDescription, count> descriptions = {};
+
+			size_t offset = 0;
+			size_t index = 0;
+
+			((descriptions[index++] = { Attributes::type, Attributes::count, Attributes::normalized, offset }, offset += Attributes::size), ...);
+
+			return descriptions;
+		}();
+	};
+
+	// Round to nearest even, values out of range become infinity.
+	inline uint16_t ToHalf(float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		uint32_t sign = (bits >> 16) & 0x8000;
+		int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+		uint32_t mantissa = bits & 0x7FFFFF;
+
+		if (((bits >> 23) & 0xFF) == 0xFF)
+		{
+			return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+		}
+
+		if (exponent >= 31)
+		{
+			return static_cast<uint16_t>(sign | 0x7C00);
+		}
+
+		if (exponent <= 0)
+		{
+			if (exponent < -10)
+			{
+				return static_cast<uint16_t>(sign);
+			}
+
+			mantissa |= 0x800000;
+
+			uint32_t shift = static_cast<uint32_t>(14 - exponent);
+			uint32_t half = mantissa >> shift;
+			uint32_t remainder = mantissa & ((1u << shift) - 1);
+			uint32_t midpoint = 1u << (shift - 1);
+
+			if (remainder > midpoint || (remainder == midpoint && (half & 1)))
+			{
+				half++;
+			}
+
+			return static_cast<uint16_t>(sign | half);
+		}
+
+		uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+		uint32_t remainder = mantissa & 0x1FFF;
+
+		// A carry into the exponent is still the right result.
+		if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+		{
+			half++;
+		}
+
+		return static_cast<uint16_t>(sign | half);
+	}
+
+	inline float FromHalf(uint16_t half)
+	{
+		uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+		uint32_t exponent = (half >> 10) & 0x1F;
+		uint32_t mantissa = half & 0x3FF;
+
+		uint32_t bits;
+
+		if (exponent == 0x1F)
+		{
+			bits = sign | 0x7F800000 | (mantissa << 13);
+		}
+		else if (exponent != 0)
+		{
+			bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+		}
+		else if (mantissa != 0)
+		{
+			// Subnormal halves are normal floats, shift the mantissa up until its leading bit is the implicit one.
+			exponent = 127 - 14;
+
+			while (!(mantissa & 0x400))
+			{
+				mantissa <<= 1;
+				exponent--;
+			}
+
+			bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+		}
+		else
+		{
+			bits = sign;
+		}
+
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+
+		return value;
+	}
+
+	inline uint8_t ToUNorm8(float value)
+	{
+		return static_cast<uint8_t>((value <= 0.0f ? 0.0f : value >= 1.0f ? 1.0f : value) * 255.0f + 0.5f);
+	}
+
+	inline uint16_t ToUNorm16(float value)
+	{
+		return static_cast<uint16_t>((value <= 0.0f ? 0.0f : value >= 1.0f ? 1.0f : value) * 65535.0f + 0.5f);
+	}
+
+	// 32 bytes, float position, colour and UV. What RenderComponent uses.
+	struct DefaultVertex
+	{
+		using Attributes = VertexAttributes<Float3, Float3, Float2>;
+
+		float x, y, z;
+		float r, g, b;
+		float uvX, uvY;
+
+		void SetUV(float u, float v)
+		{
+			uvX = u;
+			uvY = v;
+		}
+
+		void GetPosition(float& outX, float& outY, float& outZ) const
+		{
+			outX = x;
+			outY = y;
+			outZ = z;
+		}
+	};
+
+	// 16 bytes, half float position, RGBA8 colour and 16 bit UV. Positions stay exact up to 2048 and the UVs resolve 1/65535,
+	// enough for screen space sprites on atlases up to 16k. Shaders keep reading vec3, vec3 and vec2.
+	struct PackedVertex
+	{
+		using Attributes = VertexAttributes<Half4, UNorm8x4, UNorm16x2>;
+
+		uint16_t x, y, z, w;
+		uint8_t r, g, b, a;
+		uint16_t uvX, uvY;
+
+		PackedVertex() = default;
+		PackedVertex(float x, float y, float z, float r, float g, float b, float uvX, float uvY)
+			: x(ToHalf(x)), y(ToHalf(y)), z(ToHalf(z)), w(ToHalf(1.0f)), r(ToUNorm8(r)), g(ToUNorm8(g)), b(ToUNorm8(b)), a(255), uvX(ToUNorm16(uvX)), uvY(ToUNorm16(uvY))
+		{
+		}
+
+		void SetUV(float u, float v)
+		{
+			uvX = ToUNorm16(u);
+			uvY = ToUNorm16(v);
+		}
+
+		void GetPosition(float& outX, float& outY, float& outZ) const
+		{
+			outX = FromHalf(x);
+			outY = FromHalf(y);
+			outZ = FromHalf(z);
+		}
+	};
+}
\ No newline at end of file
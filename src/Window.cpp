@@ -144,6 +144,15 @@ namespace Velkro
 		glfwPollEvents();
 	}
 
+	GLFWwindow* Window::GetCurrentContext()
+	{
+		return glfwGetCurrentContext();
+	}
+	void Window::MakeContextCurrent(GLFWwindow* context)
+	{
+		glfwMakeContextCurrent(context);
+	}
+
 	void Window::Update()
 	{
 		glfwSwapBuffers(m_Window);
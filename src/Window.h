@@ -30,6 +30,9 @@ namespace Velkro
 
 		static void PollEvents();
 
+		static GLFWwindow* GetCurrentContext();
+		static void MakeContextCurrent(GLFWwindow* context);
+
 	private:
 		GLFWwindow* m_Window;
 	};
@@ -0,0 +1,766 @@
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <glad/glad.h>
+
+#include "Archive.h"
+#include "Cooked.h"
+#include "Image.h"
+#include "IO.h"
+#include "LZ4.h"
+#include "MeshOptimizer.h"
+#include "VertexLayout.h"
+#include "Log.h"
+
+// Converts source assets into the blobs loaded by Renderer::LoadTexture2D (.vtex), Renderer::LoadCookedShader (.vshd) and
+// MeshComponent::Load (.vmesh), and packs directories into archives for IO::Mount (.vpak).
+namespace Velkro::Cook
+{
+	static bool WriteFile(const std::string& path, const std::vector<uint8_t>& bytes)
+	{
+		std::ofstream file(path, std::ios::binary);
+
+		if (!file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size()))
+		{
+			VLK_CORE_ERROR("Failed to write \"{}\".", path);
+
+			return false;
+		}
+
+		return true;
+	}
+
+	// Box filters each level down from the one above it, odd edges reuse their last texel.
+	static void GenerateMipmaps(Image::ImageData& image)
+	{
+		int levelCount = Image::GetMipLevelCount(image.width, image.height);
+
+		for (int i = 1; i < levelCount; i++)
+		{
+			Image::ImageData::Level source = image.levels[i - 1];
+
+			int width = std::max(1, source.width / 2);
+			int height = std::max(1, source.height / 2);
+
+			size_t offset = image.pixels.size();
+
+			image.pixels.resize(offset + static_cast<size_t>(width) * height * 4);
+
+			const uint8_t* src = image.pixels.data() + source.offset;
+			uint8_t* dst = image.pixels.data() + offset;
+
+			for (int y = 0; y < height; y++)
+			{
+				int y0 = std::min(y * 2, source.height - 1);
+				int y1 = std::min(y * 2 + 1, source.height - 1);
+
+				for (int x = 0; x < width; x++)
+				{
+					int x0 = std::min(x * 2, source.width - 1);
+					int x1 = std::min(x * 2 + 1, source.width - 1);
+
+					for (int c = 0; c < 4; c++)
+					{
+						int sum = src[(y0 * source.width + x0) * 4 + c] + src[(y0 * source.width + x1) * 4 + c] + src[(y1 * source.width + x0) * 4 + c] + src[(y1 * source.width + x1) * 4 + c];
+
+						dst[(y * width + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+					}
+				}
+			}
+
+			image.levels.push_back({ offset, static_cast<size_t>(width) * height * 4, width, height });
+		}
+	}
+
+	static int CookTexture(const char* input, const char* output, bool mipmaps, int tileWidth, int tileHeight)
+	{
+		Image::ImageData image;
+
+		if (Image::IsContainer(input))
+		{
+			// Already in upload layout, only the mip chain and atlas metadata can be added.
+			if (!Image::LoadContainer(input, image))
+			{
+				return 1;
+			}
+
+			std::vector<uint8_t> pixels;
+
+			for (Image::ImageData::Level& level : image.levels)
+			{
+				pixels.insert(pixels.end(), image.GetPixels() + level.offset, image.GetPixels() + level.offset + level.size);
+
+				level.offset = pixels.size() - level.size;
+			}
+
+			image.pixels = std::move(pixels);
+		}
+		else
+		{
+			stbi_set_flip_vertically_on_load(true);
+
+			IO::FileView file = IO::MapFile(input);
+
+			int channels;
+			uint8_t* pixels = file.IsOpen() ? stbi_load_from_memory(file.GetPointer(), static_cast<int>(file.GetSize()), &image.width, &image.height, &channels, STBI_rgb_alpha) : nullptr;
+
+			if (!pixels)
+			{
+				VLK_CORE_ERROR("Failed to decode \"{}\": {}", input, stbi_failure_reason());
+
+				return 1;
+			}
+
+			image.internalFormat = GL_RGBA8;
+			image.format = GL_RGBA;
+			image.levels.push_back({ 0, static_cast<size_t>(image.width) * image.height * 4, image.width, image.height });
+			image.pixels.assign(pixels, pixels + image.levels[0].size);
+
+			stbi_image_free(pixels);
+		}
+
+		if (mipmaps && image.levels.size() == 1)
+		{
+			if (image.compressed)
+			{
+				VLK_CORE_WARN("\"{}\" is block compressed without mipmaps, they can't be generated here.", input);
+			}
+			else
+			{
+				GenerateMipmaps(image);
+			}
+		}
+		else if (!mipmaps)
+		{
+			image.levels.resize(1);
+		}
+
+		Cooked::TextureHeader header;
+		header.internalFormat = image.internalFormat;
+		header.format = image.format;
+		header.compressed = image.compressed;
+		header.width = image.width;
+		header.height = image.height;
+		header.levelCount = static_cast<uint32_t>(image.levels.size());
+		header.tileWidth = tileWidth;
+		header.tileHeight = tileHeight;
+
+		size_t pixelsOffset = sizeof(header) + image.levels.size() * sizeof(Cooked::TextureLevel);
+
+		pixelsOffset = (pixelsOffset + 15) & ~size_t(15);
+
+		std::vector<uint8_t> blob(pixelsOffset);
+
+		std::memcpy(blob.data(), &header, sizeof(header));
+
+		for (size_t i = 0; i < image.levels.size(); i++)
+		{
+			Image::ImageData::Level& source = image.levels[i];
+
+			Cooked::TextureLevel level = { blob.size(), source.size, source.width, source.height };
+
+			std::memcpy(blob.data() + sizeof(header) + i * sizeof(level), &level, sizeof(level));
+
+			blob.insert(blob.end(), image.pixels.begin() + source.offset, image.pixels.begin() + source.offset + source.size);
+		}
+
+		if (!WriteFile(output, blob))
+		{
+			return 1;
+		}
+
+		VLK_CORE_INFO("Cooked \"{}\" into \"{}\" ({}x{}, {} levels, {} bytes).", input, output, image.width, image.height, image.levels.size(), blob.size());
+
+		return 0;
+	}
+
+	// Inlines #include "file" directives and strips comments and blank lines, so the runtime hands the driver one flat string.
+	static bool PreprocessShader(const std::filesystem::path& path, std::string& output, int depth)
+	{
+		if (depth > 16)
+		{
+			VLK_CORE_ERROR("Shader includes nest too deep at \"{}\".", path.string());
+
+			return false;
+		}
+
+		if (!std::filesystem::exists(path))
+		{
+			VLK_CORE_ERROR("Shader \"{}\" doesn't exist.", path.string());
+
+			return false;
+		}
+
+		std::string source = IO::GetFile(path.string());
+		std::string stripped;
+
+		bool blockComment = false;
+
+		for (size_t i = 0; i < source.size(); i++)
+		{
+			if (blockComment)
+			{
+				if (source.compare(i, 2, "*/") == 0)
+				{
+					blockComment = false;
+					i++;
+				}
+				else if (source[i] == '\n')
+				{
+					stripped += '\n';
+				}
+			}
+			else if (source.compare(i, 2, "/*") == 0)
+			{
+				blockComment = true;
+				i++;
+			}
+			else if (source.compare(i, 2, "//") == 0)
+			{
+				while (i < source.size() && source[i] != '\n')
+				{
+					i++;
+				}
+
+				stripped += '\n';
+			}
+			else
+			{
+				stripped += source[i];
+			}
+		}
+
+		size_t start = 0;
+
+		while (start < stripped.size())
+		{
+			size_t end = stripped.find('\n', start);
+
+			if (end == std::string::npos)
+			{
+				end = stripped.size();
+			}
+
+			std::string_view line(stripped.data() + start, end - start);
+
+			start = end + 1;
+
+			size_t first = line.find_first_not_of(" \t\r");
+
+			if (first == std::string_view::npos)
+			{
+				continue;
+			}
+
+			line.remove_prefix(first);
+
+			if (line.starts_with("#include"))
+			{
+				size_t open = line.find('"');
+				size_t close = line.find('"', open + 1);
+
+				if (open == std::string_view::npos || close == std::string_view::npos)
+				{
+					VLK_CORE_ERROR("Malformed #include in \"{}\".", path.string());
+
+					return false;
+				}
+
+				if (!PreprocessShader(path.parent_path() / line.substr(open + 1, close - open - 1), output, depth + 1))
+				{
+					return false;
+				}
+
+				continue;
+			}
+
+			output += line;
+			output += '\n';
+		}
+
+		return true;
+	}
+
+	static int CookShader(const char* vertexPath, const char* fragmentPath, const char* output)
+	{
+		std::string vertexSource, fragmentSource;
+
+		if (!PreprocessShader(vertexPath, vertexSource, 0) || !PreprocessShader(fragmentPath, fragmentSource, 0))
+		{
+			return 1;
+		}
+
+		Cooked::ShaderHeader header;
+		header.vertexSize = static_cast<uint32_t>(vertexSource.size() + 1);
+		header.fragmentSize = static_cast<uint32_t>(fragmentSource.size() + 1);
+
+		std::vector<uint8_t> blob(sizeof(header) + header.vertexSize + header.fragmentSize);
+
+		std::memcpy(blob.data(), &header, sizeof(header));
+		std::memcpy(blob.data() + sizeof(header), vertexSource.c_str(), header.vertexSize);
+		std::memcpy(blob.data() + sizeof(header) + header.vertexSize, fragmentSource.c_str(), header.fragmentSize);
+
+		if (!WriteFile(output, blob))
+		{
+			return 1;
+		}
+
+		VLK_CORE_INFO("Cooked \"{}\" and \"{}\" into \"{}\" ({} bytes).", vertexPath, fragmentPath, output, blob.size());
+
+		return 0;
+	}
+
+	// Resolves a 1 based, or negative and relative, OBJ index. Returns -1 if it is out of range.
+	static long ResolveObjIndex(long index, size_t count)
+	{
+		long resolved = index < 0 ? static_cast<long>(count) + index : index - 1;
+
+		return resolved >= 0 && resolved < static_cast<long>(count) ? resolved : -1;
+	}
+
+	// Reads positions, optional vertex colours ("v x y z r g b") and UVs, normals aren't part of any vertex layout yet.
+	// Polygons are fanned into triangles and every material gets a submesh, in the order materials first show up. Faces
+	// before the first usemtl have no material and go into a submesh of their own, ahead of the others.
+	template<typename Vertex>
+	static bool ReadObj(const char* path, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices, std::vector<size_t>& submeshIndexCounts)
+	{
+		std::ifstream file(path);
+
+		if (!file)
+		{
+			VLK_CORE_ERROR("Failed to open \"{}\".", path);
+
+			return false;
+		}
+
+		std::vector<float> positions, colours, uvs;
+
+		std::vector<std::string> materials;
+		std::vector<std::vector<uint32_t>> submeshes(1);
+		size_t submesh = 0;
+
+		std::string line;
+		size_t lineNumber = 0;
+
+		while (std::getline(file, line))
+		{
+			lineNumber++;
+
+			std::istringstream stream(line);
+			std::string keyword;
+
+			stream >> keyword;
+
+			if (keyword == "v")
+			{
+				float x = 0.0f, y = 0.0f, z = 0.0f, r = 1.0f, g = 1.0f, b = 1.0f;
+
+				stream >> x >> y >> z;
+
+				if (!(stream >> r >> g >> b))
+				{
+					r = g = b = 1.0f;
+				}
+
+				positions.insert(positions.end(), { x, y, z });
+				colours.insert(colours.end(), { r, g, b });
+			}
+			else if (keyword == "vt")
+			{
+				float u = 0.0f, v = 0.0f;
+
+				stream >> u >> v;
+
+				uvs.insert(uvs.end(), { u, v });
+			}
+			else if (keyword == "usemtl")
+			{
+				std::string name;
+				stream >> name;
+
+				size_t material = std::find(materials.begin(), materials.end(), name) - materials.begin();
+
+				if (material == materials.size())
+				{
+					materials.push_back(name);
+				}
+
+				submesh = material + 1;
+
+				if (submesh >= submeshes.size())
+				{
+					submeshes.resize(submesh + 1);
+				}
+			}
+			else if (keyword == "f")
+			{
+				std::vector<uint32_t> corners;
+				std::string corner;
+
+				while (stream >> corner)
+				{
+					const char* text = corner.c_str();
+					char* end;
+
+					long position = ResolveObjIndex(std::strtol(text, &end, 10), positions.size() / 3);
+					long uv = -1;
+
+					if (position < 0)
+					{
+						VLK_CORE_ERROR("\"{}\" line {}: Face references a vertex that doesn't exist.", path, lineNumber);
+
+						return false;
+					}
+
+					if (*end == '/' && end[1] != '/')
+					{
+						uv = ResolveObjIndex(std::strtol(end + 1, &end, 10), uvs.size() / 2);
+
+						if (uv < 0)
+						{
+							VLK_CORE_ERROR("\"{}\" line {}: Face references a texture coordinate that doesn't exist.", path, lineNumber);
+
+							return false;
+						}
+					}
+
+					float u = uv >= 0 ? uvs[uv * 2] : 0.0f;
+					float v = uv >= 0 ? uvs[uv * 2 + 1] : 0.0f;
+
+					// Corners are kept apart here, ProcessMesh welds the ones that turn out identical.
+					corners.push_back(static_cast<uint32_t>(vertices.size()));
+					vertices.push_back(Vertex{ positions[position * 3], positions[position * 3 + 1], positions[position * 3 + 2], colours[position * 3], colours[position * 3 + 1], colours[position * 3 + 2], u, v });
+				}
+
+				for (size_t i = 2; i < corners.size(); i++)
+				{
+					submeshes[submesh].insert(submeshes[submesh].end(), { corners[0], corners[i - 1], corners[i] });
+				}
+			}
+		}
+
+		for (std::vector<uint32_t>& submeshIndices : submeshes)
+		{
+			if (!submeshIndices.empty())
+			{
+				indices.insert(indices.end(), submeshIndices.begin(), submeshIndices.end());
+				submeshIndexCounts.push_back(submeshIndices.size());
+			}
+		}
+
+		if (indices.empty())
+		{
+			VLK_CORE_ERROR("\"{}\" has no faces.", path);
+
+			return false;
+		}
+
+		return true;
+	}
+
+	template<typename Vertex>
+	static int CookMesh(const char* input, const char* output, const MeshOptions& options)
+	{
+		std::vector<Vertex> vertices;
+		std::vector<uint32_t> indices;
+		std::vector<size_t> submeshIndexCounts;
+
+		if (!ReadObj(input, vertices, indices, submeshIndexCounts))
+		{
+			return 1;
+		}
+
+		// Positions after packing, so LODs and bounds match what the runtime draws.
+		std::vector<float> positions(vertices.size() * 3);
+
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			vertices[i].GetPosition(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+		}
+
+		MeshOptimizer::ProcessedMesh mesh;
+		MeshOptimizer::ProcessMesh(mesh, vertices.data(), vertices.size(), sizeof(Vertex), positions.data(), indices.data(), submeshIndexCounts.data(), submeshIndexCounts.size(), options);
+
+		Cooked::MeshHeader header;
+		header.vertexSize = sizeof(Vertex);
+		header.attributeCount = static_cast<uint32_t>(Vertex::Attributes::count);
+
+		static_assert(Vertex::Attributes::count <= Cooked::MaxMeshAttributes);
+
+		for (uint32_t i = 0; i < header.attributeCount; i++)
+		{
+			const AttributeDescription& attribute = Vertex::Attributes::descriptions[i];
+
+			header.attributes[i] = { attribute.type, static_cast<uint32_t>(attribute.count), attribute.normalized, static_cast<uint32_t>(attribute.offset) };
+		}
+
+		for (uint32_t i = header.attributeCount; i < Cooked::MaxMeshAttributes; i++)
+		{
+			header.attributes[i] = {};
+		}
+
+		header.indexSize = MeshOptimizer::FitsShortIndices(mesh.vertexCount) ? sizeof(uint16_t) : sizeof(uint32_t);
+		header.lodCount = static_cast<uint32_t>(mesh.lods.size());
+		header.submeshCount = static_cast<uint32_t>(mesh.submeshCount);
+
+		std::copy(mesh.centre, mesh.centre + 3, header.centre);
+		header.radius = mesh.radius;
+
+		std::vector<Cooked::MeshRange> ranges;
+
+		for (size_t i = 0; i < mesh.lods.size(); i++)
+		{
+			ranges.push_back({ static_cast<uint32_t>(mesh.lods[i].firstIndex), static_cast<uint32_t>(mesh.lods[i].indexCount), mesh.lodScreenSizes[i] });
+		}
+
+		for (const MeshOptimizer::ProcessedMesh::Range& submesh : mesh.submeshes)
+		{
+			ranges.push_back({ static_cast<uint32_t>(submesh.firstIndex), static_cast<uint32_t>(submesh.indexCount), 0.0f });
+		}
+
+		std::vector<uint8_t> blob(sizeof(header) + ranges.size() * sizeof(Cooked::MeshRange));
+
+		blob.resize((blob.size() + 15) & ~size_t(15));
+
+		header.vertexCount = mesh.vertexCount;
+		header.vertexOffset = blob.size();
+
+		blob.insert(blob.end(), mesh.vertices.begin(), mesh.vertices.end());
+		blob.resize((blob.size() + 15) & ~size_t(15));
+
+		header.indexCount = mesh.indices.size();
+		header.indexOffset = blob.size();
+
+		blob.resize(blob.size() + mesh.indices.size() * header.indexSize);
+
+		if (header.indexSize == sizeof(uint16_t))
+		{
+			std::vector<uint16_t> shortIndices(mesh.indices.size());
+
+			MeshOptimizer::ConvertToShortIndices(shortIndices.data(), mesh.indices.data(), mesh.indices.size());
+
+			std::memcpy(blob.data() + header.indexOffset, shortIndices.data(), shortIndices.size() * sizeof(uint16_t));
+		}
+		else
+		{
+			std::memcpy(blob.data() + header.indexOffset, mesh.indices.data(), mesh.indices.size() * sizeof(uint32_t));
+		}
+
+		std::memcpy(blob.data(), &header, sizeof(header));
+		std::memcpy(blob.data() + sizeof(header), ranges.data(), ranges.size() * sizeof(Cooked::MeshRange));
+
+		if (!WriteFile(output, blob))
+		{
+			return 1;
+		}
+
+		VLK_CORE_INFO("Cooked \"{}\" into \"{}\" ({} vertices welded to {}, {} triangles, {} LODs, {} submeshes, {} bytes).", input, output, vertices.size(), mesh.vertexCount, mesh.lods.front().indexCount / 3, mesh.lods.size(), mesh.submeshCount, blob.size());
+
+		return 0;
+	}
+
+	// Entries keep their path as given, so "pack assets game.vpak" serves "assets/sprite.png".
+	static int Pack(const char* directory, const char* output, bool compress)
+	{
+		struct PackedFile
+		{
+			std::string path;
+			uint64_t hash;
+		};
+
+		std::vector<PackedFile> files;
+
+		std::error_code error;
+
+		for (const std::filesystem::directory_entry& file : std::filesystem::recursive_directory_iterator(directory, error))
+		{
+			if (file.is_regular_file())
+			{
+				std::string path = Archive::NormalizePath(file.path().generic_string());
+
+				files.push_back({ path, Archive::HashPath(path) });
+			}
+		}
+
+		if (error)
+		{
+			VLK_CORE_ERROR("Failed to read directory \"{}\": {}", directory, error.message());
+
+			return 1;
+		}
+
+		std::sort(files.begin(), files.end(), [](const PackedFile& a, const PackedFile& b) { return a.hash != b.hash ? a.hash < b.hash : a.path < b.path; });
+
+		Archive::Header header;
+		header.entryCount = static_cast<uint32_t>(files.size());
+		header.entriesOffset = sizeof(header);
+
+		std::vector<Archive::Entry> entries(files.size());
+		std::string names;
+
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			entries[i].hash = files[i].hash;
+			entries[i].nameOffset = static_cast<uint32_t>(names.size());
+			entries[i].nameLength = static_cast<uint32_t>(files[i].path.size());
+			entries[i].flags = 0;
+			entries[i].reserved = 0;
+
+			names += files[i].path;
+		}
+
+		header.namesOffset = header.entriesOffset + entries.size() * sizeof(Archive::Entry);
+
+		std::vector<uint8_t> blob(header.namesOffset + names.size());
+
+		std::memcpy(blob.data() + header.namesOffset, names.data(), names.size());
+
+		size_t rawSize = 0;
+
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			IO::FileView file = IO::FileView::OpenLoose(files[i].path);
+
+			if (!file.IsOpen())
+			{
+				VLK_CORE_ERROR("Failed to read \"{}\".", files[i].path);
+
+				return 1;
+			}
+
+			// Entries start 16 byte aligned so uncompressed ones can be used in place.
+			blob.resize((blob.size() + 15) & ~size_t(15));
+
+			Archive::Entry& entry = entries[i];
+			entry.offset = blob.size();
+			entry.size = file.GetSize();
+
+			rawSize += file.GetSize();
+
+			if (compress && file.GetSize() > 0)
+			{
+				size_t compressedSize = LZ4::Compress(file.GetPointer(), file.GetSize(), blob);
+
+				// Not worth a decompression for less than an eighth saved, store it raw and map it directly instead.
+				if (compressedSize < file.GetSize() - file.GetSize() / 8)
+				{
+					entry.storedSize = compressedSize;
+					entry.flags = Archive::EntryCompressed;
+
+					continue;
+				}
+
+				blob.resize(entry.offset);
+			}
+
+			blob.insert(blob.end(), file.GetPointer(), file.GetPointer() + file.GetSize());
+
+			entry.storedSize = file.GetSize();
+		}
+
+		std::memcpy(blob.data(), &header, sizeof(header));
+		std::memcpy(blob.data() + header.entriesOffset, entries.data(), entries.size() * sizeof(Archive::Entry));
+
+		if (!WriteFile(output, blob))
+		{
+			return 1;
+		}
+
+		VLK_CORE_INFO("Packed {} files from \"{}\" into \"{}\" ({} bytes, {} before packing).", files.size(), directory, output, blob.size(), rawSize);
+
+		return 0;
+	}
+
+	static void PrintUsage()
+	{
+		VLK_CORE_INFO("Usage:\n"
+			"  VelkroCook texture <input> <output.vtex> [--no-mips] [--tile <width> <height>]\n"
+			"  VelkroCook shader <vertex> <fragment> <output.vshd>\n"
+			"  VelkroCook mesh <input.obj> <output.vmesh> [--packed] [--lods <count>]\n"
+			"  VelkroCook pack <directory> <output.vpak> [--store]");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc >= 4 && std::strcmp(argv[1], "texture") == 0)
+	{
+		bool mipmaps = true;
+		int tileWidth = 0, tileHeight = 0;
+
+		for (int i = 4; i < argc; i++)
+		{
+			if (std::strcmp(argv[i], "--no-mips") == 0)
+			{
+				mipmaps = false;
+			}
+			else if (std::strcmp(argv[i], "--tile") == 0 && i + 2 < argc)
+			{
+				tileWidth = std::atoi(argv[++i]);
+				tileHeight = std::atoi(argv[++i]);
+			}
+			else
+			{
+				Velkro::Cook::PrintUsage();
+
+				return 1;
+			}
+		}
+
+		return Velkro::Cook::CookTexture(argv[2], argv[3], mipmaps, tileWidth, tileHeight);
+	}
+
+	if (argc == 5 && std::strcmp(argv[1], "shader") == 0)
+	{
+		return Velkro::Cook::CookShader(argv[2], argv[3], argv[4]);
+	}
+
+	if (argc >= 4 && std::strcmp(argv[1], "mesh") == 0)
+	{
+		bool packed = false;
+
+		Velkro::MeshOptions options;
+
+		for (int i = 4; i < argc; i++)
+		{
+			if (std::strcmp(argv[i], "--packed") == 0)
+			{
+				packed = true;
+			}
+			else if (std::strcmp(argv[i], "--lods") == 0 && i + 1 < argc)
+			{
+				options.lodCount = std::max(1, std::atoi(argv[++i]));
+			}
+			else
+			{
+				Velkro::Cook::PrintUsage();
+
+				return 1;
+			}
+		}
+
+		if (packed)
+		{
+			return Velkro::Cook::CookMesh<Velkro::PackedVertex>(argv[2], argv[3], options);
+		}
+
+		return Velkro::Cook::CookMesh<Velkro::DefaultVertex>(argv[2], argv[3], options);
+	}
+
+	if ((argc == 4 || (argc == 5 && std::strcmp(argv[4], "--store") == 0)) && std::strcmp(argv[1], "pack") == 0)
+	{
+		return Velkro::Cook::Pack(argv[2], argv[3], argc == 4);
+	}
+
+	Velkro::Cook::PrintUsage();
+
+	return 1;
+}
\ No newline at end of file